@@ -15,10 +15,12 @@
 
 #include $(TMK_PATH)/protocol.mk
 
-TEST_PATH=tests/$(TEST)
+TEST_PATH ?= tests/$(TEST)
+TEST_KEYMAP ?= $(TEST_PATH)/keymap.c
+TEST_CONFIG ?= $(TEST_PATH)/config.h
 
 $(TEST)_SRC= \
-	$(TEST_PATH)/keymap.c \
+	$(TEST_KEYMAP) \
 	$(TMK_COMMON_SRC) \
 	$(QUANTUM_SRC) \
 	$(SRC) \
@@ -29,5 +31,11 @@ $(TEST)_SRC= \
 $(TEST)_SRC += $(patsubst $(ROOTDIR)/%,%,$(wildcard $(TEST_PATH)/*.cpp))
 
 $(TEST)_DEFS=$(TMK_COMMON_DEFS) $(OPT_DEFS)
-$(TEST)_CONFIG=$(TEST_PATH)/config.h
-VPATH+=$(TOP_DIR)/tests/test_common
\ No newline at end of file
+$(TEST)_CONFIG=$(TEST_CONFIG)
+VPATH+=$(TOP_DIR)/tests/test_common
+
+ifeq ($(strip $(KEYMAP_ACTION_TABLE)), yes)
+    KEYMAP_ACTION_TABLE_OUTPUT := $(TEST_OBJ)/$(TEST)
+    KEYMAP_ACTION_TABLE_KEYMAP := $(TEST_KEYMAP)
+    include $(QUANTUM_PATH)/keymap_action_table.mk
+endif
@@ -265,6 +265,12 @@ $(KEYBOARD_OUTPUT)_DEFS := $(PROJECT_DEFS) $(GFXDEFS)
 $(KEYBOARD_OUTPUT)_INC := $(PROJECT_INC) $(GFXINC)
 $(KEYBOARD_OUTPUT)_CONFIG := $(PROJECT_CONFIG)
 
+ifeq ($(strip $(KEYMAP_ACTION_TABLE)), yes)
+    KEYMAP_ACTION_TABLE_OUTPUT := $(KEYMAP_OUTPUT)
+    KEYMAP_ACTION_TABLE_KEYMAP := $(KEYMAP_C)
+    include $(QUANTUM_PATH)/keymap_action_table.mk
+endif
+
 # Default target.
 all: build sizeafter
 
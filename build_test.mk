@@ -41,6 +41,8 @@ all: elf
 
 VPATH += $(COMMON_VPATH)
 PLATFORM:=TEST
+# the test driver in tests/test_common, instead of a USB protocol
+OPT_DEFS += -DPROTOCOL_TEST
 
 ifneq ($(filter $(FULL_TESTS),$(TEST)),)
 include tests/$(TEST)/rules.mk
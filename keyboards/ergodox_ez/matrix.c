@@ -62,6 +62,9 @@ static matrix_row_t matrix[MATRIX_ROWS];
 // already changed in the last DEBOUNCE scans.
 static uint8_t debounce_matrix[MATRIX_ROWS * MATRIX_COLS];
 
+/* rows of matrix[] changed since the last matrix_changed_rows() */
+static matrix_changed_t rows_changed;
+
 static matrix_row_t read_cols(uint8_t row);
 static void init_cols(void);
 static void unselect_rows(void);
@@ -140,6 +143,7 @@ void matrix_power_up(void) {
     for (uint8_t i=0; i < MATRIX_ROWS; i++) {
         matrix[i] = 0;
     }
+    rows_changed = MATRIX_CHANGED_ALL;
 
 #ifdef DEBUG_MATRIX_SCAN_RATE
     matrix_timer = timer_read32();
@@ -210,8 +214,11 @@ uint8_t matrix_scan(void)
         wait_us(30);  // without this wait read unstable value.
         matrix_row_t mask = debounce_mask(i);
         matrix_row_t cols = (read_cols(i) & mask) | (matrix[i] & ~mask);
-        debounce_report(cols ^ matrix[i], i);
-        matrix[i] = cols;
+        if (cols != matrix[i]) {
+            debounce_report(cols ^ matrix[i], i);
+            rows_changed |= ((matrix_changed_t)1 << i);
+            matrix[i] = cols;
+        }
 
         unselect_rows();
     }
@@ -226,6 +233,13 @@ bool matrix_is_modified(void) // deprecated and evidently not called.
     return true;
 }
 
+matrix_changed_t matrix_changed_rows(void)
+{
+    matrix_changed_t changed = rows_changed;
+    rows_changed = 0;
+    return changed;
+}
+
 inline
 bool matrix_is_on(uint8_t row, uint8_t col)
 {
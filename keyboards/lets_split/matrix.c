@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "pro_micro.h"
 #include "config.h"
 #include "timer.h"
+#include "debounce.h"
 
 #ifdef USE_I2C
 #  include "i2c.h"
@@ -37,15 +38,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #  include "serial.h"
 #endif
 
-#ifndef DEBOUNCING_DELAY
-#   define DEBOUNCING_DELAY 5
-#endif
-
-#if (DEBOUNCING_DELAY > 0)
-    static uint16_t debouncing_time;
-    static bool debouncing = false;
-#endif
-
 #if (MATRIX_COLS <= 8)
 #    define print_matrix_header()  print("\nr/c 01234567\n")
 #    define print_matrix_row(row)  print_bin_reverse8(matrix_get_row(row))
@@ -69,6 +61,9 @@ static const uint8_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
 static matrix_row_t matrix[MATRIX_ROWS];
 static matrix_row_t matrix_debouncing[MATRIX_ROWS];
 
+/* rows of matrix[] changed since the last matrix_changed_rows() */
+static matrix_changed_t rows_changed;
+
 #if (DIODE_DIRECTION == COL2ROW)
     static void init_cols(void);
     static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row);
@@ -143,6 +138,11 @@ void matrix_init(void)
         matrix[i] = 0;
         matrix_debouncing[i] = 0;
     }
+    rows_changed = 0;
+
+#if (DEBOUNCING_DELAY > 0)
+    debounce_init(ROWS_PER_HAND);
+#endif
 
     matrix_init_quantum();
 
@@ -151,20 +151,21 @@ void matrix_init(void)
 uint8_t _matrix_scan(void)
 {
     int offset = isLeftHand ? 0 : (ROWS_PER_HAND);
+#if (DEBOUNCING_DELAY > 0)
+    bool matrix_changed = false;
+#endif
 #if (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
 #       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_cols_on_row(matrix_debouncing+offset, current_row);
-
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
+            if (read_cols_on_row(matrix_debouncing+offset, current_row)) {
+                matrix_changed = true;
                 PORTD ^= (1 << 2);
             }
-
 #       else
-            read_cols_on_row(matrix+offset, current_row);
+            if (read_cols_on_row(matrix+offset, current_row)) {
+                rows_changed |= ((matrix_changed_t)1 << (current_row+offset));
+            }
 #       endif
 
     }
@@ -173,30 +174,32 @@ uint8_t _matrix_scan(void)
     // Set col, read rows
     for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++) {
 #       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_rows_on_col(matrix_debouncing+offset, current_col);
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
-            }
+            matrix_changed |= read_rows_on_col(matrix_debouncing+offset, current_col);
 #       else
-             read_rows_on_col(matrix+offset, current_col);
+            if (read_rows_on_col(matrix+offset, current_col)) {
+                rows_changed = MATRIX_CHANGED_ALL;
+            }
 #       endif
 
     }
 #endif
 
 #   if (DEBOUNCING_DELAY > 0)
-        if (debouncing && (timer_elapsed(debouncing_time) > DEBOUNCING_DELAY)) {
-            for (uint8_t i = 0; i < ROWS_PER_HAND; i++) {
-                matrix[i+offset] = matrix_debouncing[i+offset];
-            }
-            debouncing = false;
-        }
+        rows_changed |= debounce(matrix_debouncing+offset, matrix+offset, ROWS_PER_HAND, matrix_changed) << offset;
 #   endif
 
     return 1;
 }
 
+// Store a row received from the other half
+static void set_slave_row(uint8_t row, matrix_row_t value)
+{
+    if (matrix[row] != value) {
+        matrix[row] = value;
+        rows_changed |= ((matrix_changed_t)1 << row);
+    }
+}
+
 #ifdef USE_I2C
 
 // Get rows from other half over i2c
@@ -217,9 +220,9 @@ int i2c_transaction(void) {
     if (!err) {
         int i;
         for (i = 0; i < ROWS_PER_HAND-1; ++i) {
-            matrix[slaveOffset+i] = i2c_master_read(I2C_ACK);
+            set_slave_row(slaveOffset+i, i2c_master_read(I2C_ACK));
         }
-        matrix[slaveOffset+i] = i2c_master_read(I2C_NACK);
+        set_slave_row(slaveOffset+i, i2c_master_read(I2C_NACK));
         i2c_master_stop();
     } else {
 i2c_error: // the cable is disconnceted, or something else went wrong
@@ -240,7 +243,7 @@ int serial_transaction(void) {
     }
 
     for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        matrix[slaveOffset+i] = serial_slave_buffer[i];
+        set_slave_row(slaveOffset+i, serial_slave_buffer[i]);
     }
     return 0;
 }
@@ -264,7 +267,7 @@ uint8_t matrix_scan(void)
             // reset other half if disconnected
             int slaveOffset = (isLeftHand) ? (ROWS_PER_HAND) : 0;
             for (int i = 0; i < ROWS_PER_HAND; ++i) {
-                matrix[slaveOffset+i] = 0;
+                set_slave_row(slaveOffset+i, 0);
             }
         }
     } else {
@@ -294,10 +297,19 @@ void matrix_slave_scan(void) {
 
 bool matrix_is_modified(void)
 {
-    if (debouncing) return false;
+#if (DEBOUNCING_DELAY > 0)
+    if (debounce_active()) return false;
+#endif
     return true;
 }
 
+matrix_changed_t matrix_changed_rows(void)
+{
+    matrix_changed_t changed = rows_changed;
+    rows_changed = 0;
+    return changed;
+}
+
 inline
 bool matrix_is_on(uint8_t row, uint8_t col)
 {
@@ -0,0 +1,53 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/* Set 0 if debouncing isn't needed */
+#ifndef DEBOUNCING_DELAY
+#   define DEBOUNCING_DELAY 5
+#endif
+
+/* The algorithm is picked with DEBOUNCE_TYPE in rules.mk:
+ *   global  - wait until the whole matrix has been stable for DEBOUNCING_DELAY ms
+ *   per_row - the same, but every row has its own timer
+ *   per_key - report presses immediately, releases once the key has been
+ *             released for DEBOUNCING_DELAY ms
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void debounce_init(uint8_t num_rows);
+/* Updates cooked[] from the raw[] rows that were just read from the hardware.
+ * changed tells whether raw[] differs from the previous scan.
+ * Returns the rows of cooked[] that changed.
+ */
+matrix_changed_t debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+/* whether some keys are still waiting for the debounce period to end */
+bool debounce_active(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
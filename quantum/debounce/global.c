@@ -0,0 +1,53 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Any change anywhere in the matrix restarts a single timer, the whole
+ * matrix is copied once nothing has changed for DEBOUNCING_DELAY ms.
+ */
+#include "debounce.h"
+#include "timer.h"
+
+static uint16_t debouncing_time;
+static bool debouncing = false;
+
+void debounce_init(uint8_t num_rows) {
+    debouncing = false;
+}
+
+matrix_changed_t debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    matrix_changed_t rows_changed = 0;
+
+    if (changed) {
+        debouncing = true;
+        debouncing_time = timer_read();
+    }
+
+    if (debouncing && (timer_elapsed(debouncing_time) > DEBOUNCING_DELAY)) {
+        for (uint8_t i = 0; i < num_rows; i++) {
+            if (cooked[i] != raw[i]) {
+                cooked[i] = raw[i];
+                rows_changed |= ((matrix_changed_t)1 << i);
+            }
+        }
+        debouncing = false;
+    }
+    return rows_changed;
+}
+
+bool debounce_active(void) {
+    return debouncing;
+}
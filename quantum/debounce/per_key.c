@@ -0,0 +1,96 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Asymmetric per key debouncing. A press is reported as soon as it's seen,
+ * since a switch doesn't close by itself. A release is only reported once
+ * the key has stayed open for DEBOUNCING_DELAY ms, any contact bounce in
+ * between cancels it. Other keys are never delayed.
+ */
+#include "debounce.h"
+#include "timer.h"
+
+#if (DEBOUNCING_DELAY > 255)
+#   error "DEBOUNCING_DELAY has to fit in 8 bits for per_key debouncing"
+#endif
+
+/* ms left until a pending release is accepted */
+static uint8_t release_countdown[MATRIX_ROWS * MATRIX_COLS];
+static matrix_row_t release_pending[MATRIX_ROWS];
+static bool releasing = false;
+static uint16_t last_time;
+
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t i = 0; i < num_rows; i++) {
+        release_pending[i] = 0;
+    }
+    releasing = false;
+    last_time = timer_read();
+}
+
+matrix_changed_t debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    matrix_changed_t rows_changed = 0;
+    uint16_t now = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+    last_time = now;
+
+    // cooked only differs from raw while a release is pending
+    if (!changed && !releasing) {
+        return 0;
+    }
+
+    releasing = false;
+    for (uint8_t i = 0; i < num_rows; i++) {
+        matrix_row_t pressed = raw[i] & ~cooked[i];
+        matrix_row_t released = cooked[i] & ~raw[i];
+
+        // keys that bounced back cancel their release
+        release_pending[i] &= released;
+
+        if (pressed) {
+            cooked[i] |= pressed;
+            rows_changed |= ((matrix_changed_t)1 << i);
+        }
+        if (!released) {
+            continue;
+        }
+
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            matrix_row_t col_bit = ((matrix_row_t)1 << col);
+            if (!(released & col_bit)) {
+                continue;
+            }
+            uint8_t *countdown = &release_countdown[i * MATRIX_COLS + col];
+            if (!(release_pending[i] & col_bit)) {
+                release_pending[i] |= col_bit;
+                *countdown = DEBOUNCING_DELAY;
+            } else if (*countdown <= elapsed) {
+                release_pending[i] &= ~col_bit;
+                cooked[i] &= ~col_bit;
+                rows_changed |= ((matrix_changed_t)1 << i);
+                continue;
+            } else {
+                *countdown -= elapsed;
+            }
+            releasing = true;
+        }
+    }
+    return rows_changed;
+}
+
+bool debounce_active(void) {
+    return releasing;
+}
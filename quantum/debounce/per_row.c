@@ -0,0 +1,68 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Like the global algorithm, but every row has its own timer, so a bouncing
+ * key only delays the other keys on the same row.
+ */
+#include "debounce.h"
+#include "timer.h"
+
+static matrix_row_t raw_prev[MATRIX_ROWS];
+static uint16_t debouncing_time[MATRIX_ROWS];
+static matrix_changed_t debouncing = 0;
+
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t i = 0; i < num_rows; i++) {
+        raw_prev[i] = 0;
+    }
+    debouncing = 0;
+}
+
+matrix_changed_t debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    matrix_changed_t rows_changed = 0;
+
+    if (changed) {
+        uint16_t now = timer_read();
+        for (uint8_t i = 0; i < num_rows; i++) {
+            if (raw_prev[i] != raw[i]) {
+                raw_prev[i] = raw[i];
+                debouncing |= ((matrix_changed_t)1 << i);
+                debouncing_time[i] = now;
+            }
+        }
+    }
+
+    if (!debouncing) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < num_rows; i++) {
+        matrix_changed_t row_bit = ((matrix_changed_t)1 << i);
+        if ((debouncing & row_bit) && (timer_elapsed(debouncing_time[i]) > DEBOUNCING_DELAY)) {
+            if (cooked[i] != raw[i]) {
+                cooked[i] = raw[i];
+                rows_changed |= row_bit;
+            }
+            debouncing &= ~row_bit;
+        }
+    }
+    return rows_changed;
+}
+
+bool debounce_active(void) {
+    return debouncing;
+}
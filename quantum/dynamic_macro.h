@@ -18,7 +18,9 @@
 #ifndef DYNAMIC_MACROS_H
 #define DYNAMIC_MACROS_H
 
+#include <string.h>
 #include "action_layer.h"
+#include "eeprom.h"
 
 #ifndef DYNAMIC_MACRO_SIZE
 /* May be overridden with a custom value. Be aware that the effective
@@ -33,6 +35,24 @@
 #define DYNAMIC_MACRO_SIZE 128
 #endif
 
+#ifndef DYNAMIC_MACRO_BYTES
+/* The size of the macro buffer in bytes. The events are packed into 3
+ * bytes when they come less than 128ms apart, and 4 bytes otherwise, on
+ * a keyboard with up to 128 keys. At typing speed most events are 4
+ * bytes, so this fits DYNAMIC_MACRO_SIZE events in two thirds of the RAM
+ * the unpacked events took on AVR, where a keyrecord_t is 6 bytes.
+ */
+#define DYNAMIC_MACRO_BYTES (DYNAMIC_MACRO_SIZE * 4)
+#endif
+
+#if DYNAMIC_MACRO_BYTES > 0xFFFF
+#error "DYNAMIC_MACRO_BYTES must be less than 65536"
+#endif
+
+#ifndef DYNAMIC_MACRO_SLOTS
+#define DYNAMIC_MACRO_SLOTS 2
+#endif
+
 /* DYNAMIC_MACRO_RANGE must be set as the last element of user's
  * "planck_keycodes" enum prior to including this header. This allows
  * us to 'extend' it.
@@ -43,8 +63,14 @@ enum dynamic_macro_keycodes {
     DYN_REC_STOP,
     DYN_MACRO_PLAY1,
     DYN_MACRO_PLAY2,
+    /* Followed by the record and play keys of the slots past 2 */
+    DYN_MACRO_SLOT3,
 };
 
+/* The keys of any slot, counting from 1. */
+#define DYN_REC_START(n) ((n) == 1 ? DYN_REC_START1 : (n) == 2 ? DYN_REC_START2 : DYN_MACRO_SLOT3 + ((n) - 3) * 2)
+#define DYN_MACRO_PLAY(n) ((n) == 1 ? DYN_MACRO_PLAY1 : (n) == 2 ? DYN_MACRO_PLAY2 : DYN_MACRO_SLOT3 + ((n) - 3) * 2 + 1)
+
 /* Blink the LEDs to notify the user about some event. */
 void dynamic_macro_led_blink(void)
 {
@@ -55,126 +81,352 @@ void dynamic_macro_led_blink(void)
 #endif
 }
 
-/* Convenience macros used for retrieving the debug info. All of them
- * need a `direction` variable accessible at the call site.
+/* All the macros share one buffer of packed events, each slot is a
+ * range of it. The slots are kept next to each other from the start of
+ * the buffer, in no particular order, so that the free space is all at
+ * the end:
+ *
+ * +------------------------------------------------------------+
+ * | slot 2 | slot 1 |  slot 3  |>>> recording >>>              |
+ * +------------------------------------------------------------+
+ *                                               ^
+ *                                        dynamic_macro_used
+ *
+ * Recording a slot first removes its old macro, and then appends the
+ * new one after the others. Apart from this, there are no arbitrary
+ * limits for the macros' length in relation to each other.
+ */
+static uint8_t dynamic_macro_buffer[DYNAMIC_MACRO_BYTES];
+static uint16_t dynamic_macro_used;
+static struct {
+    uint16_t offset;
+    uint16_t length;
+} dynamic_macro_slots[DYNAMIC_MACRO_SLOTS];
+
+/* 0 - no macro is being recorded or played right now, otherwise the
+ * slot being recorded or played, counting from 1 */
+static uint8_t dynamic_macro_recording;
+static uint8_t dynamic_macro_playing;
+
+/* The recording in progress */
+static uint16_t dynamic_macro_record_pointer;
+static uint16_t dynamic_macro_record_trimmed_end;
+/* Set when an event didn't fit, the rest of the recording is dropped */
+static bool dynamic_macro_record_full;
+static uint16_t dynamic_macro_record_time;
+
+/* The playback in progress */
+static uint16_t dynamic_macro_play_pointer;
+static uint16_t dynamic_macro_play_end;
+static uint16_t dynamic_macro_play_time;
+static uint32_t dynamic_macro_saved_layer_state;
+
+/* A packed event is a byte with the press bit (0x80), the interrupted
+ * bit (0x40) and the tap count (0x0F), followed by the key index
+ * (row * MATRIX_COLS + col) and the milliseconds since the previous
+ * event, both as varints of 7 bits per byte, low bits first.
  */
-#define DYNAMIC_MACRO_CURRENT_SLOT() (direction > 0 ? 1 : 2)
-#define DYNAMIC_MACRO_CURRENT_LENGTH(BEGIN, POINTER) \
-    ((int)(direction * ((POINTER) - (BEGIN))))
-#define DYNAMIC_MACRO_CURRENT_CAPACITY(BEGIN, END2) \
-    ((int)(direction * ((END2) - (BEGIN)) + 1))
+#define DYNAMIC_MACRO_EVENT_MAX_SIZE 6
+#define DYNAMIC_MACRO_MAX_DELAY 0x3FFF
+
+static uint8_t dynamic_macro_write_varint(uint8_t *buffer, uint16_t value)
+{
+    uint8_t size = 0;
+    while (value >= 0x80) {
+        buffer[size++] = 0x80 | (value & 0x7F);
+        value >>= 7;
+    }
+    buffer[size++] = value;
+    return size;
+}
+
+static uint8_t dynamic_macro_read_varint(const uint8_t *buffer, uint16_t *value)
+{
+    uint8_t size = 0;
+    *value = 0;
+    do {
+        *value |= (uint16_t)(buffer[size] & 0x7F) << (7 * size);
+    } while (buffer[size++] & 0x80);
+    return size;
+}
 
 /**
- * Start recording of the dynamic macro.
+ * Pack a key event.
  *
- * @param[out] macro_pointer The new macro buffer iterator.
- * @param[in]  macro_buffer  The macro buffer used to initialize macro_pointer.
+ * @param buffer[out] At least DYNAMIC_MACRO_EVENT_MAX_SIZE bytes.
+ * @param record[in]  The key event.
+ * @param delay[in]   The milliseconds since the previous event.
+ * @return The packed size.
  */
-void dynamic_macro_record_start(
-    keyrecord_t **macro_pointer, keyrecord_t *macro_buffer)
+uint8_t dynamic_macro_encode_event(uint8_t *buffer, const keyrecord_t *record, uint16_t delay)
 {
-    dprintln("dynamic macro recording: started");
+    uint8_t size = 1;
+    buffer[0] = (record->event.pressed ? 0x80 : 0)
+#ifndef NO_ACTION_TAPPING
+        | (record->tap.interrupted ? 0x40 : 0) | (record->tap.count & 0x0F)
+#endif
+        ;
+    size += dynamic_macro_write_varint(&buffer[size],
+        record->event.key.row * MATRIX_COLS + record->event.key.col);
+    size += dynamic_macro_write_varint(&buffer[size],
+        delay < DYNAMIC_MACRO_MAX_DELAY ? delay : DYNAMIC_MACRO_MAX_DELAY);
+    return size;
+}
 
-    dynamic_macro_led_blink();
+/**
+ * Unpack a key event packed by dynamic_macro_encode_event(). The event
+ * time is left for the caller.
+ *
+ * @return The packed size.
+ */
+uint8_t dynamic_macro_decode_event(const uint8_t *buffer, keyrecord_t *record, uint16_t *delay)
+{
+    uint8_t size = 1;
+    uint16_t key;
+    size += dynamic_macro_read_varint(&buffer[size], &key);
+    size += dynamic_macro_read_varint(&buffer[size], delay);
+    record->event.key.row = key / MATRIX_COLS;
+    record->event.key.col = key % MATRIX_COLS;
+    record->event.pressed = buffer[0] & 0x80;
+#ifndef NO_ACTION_TAPPING
+    record->tap.interrupted = (buffer[0] & 0x40) != 0;
+    record->tap.count = buffer[0] & 0x0F;
+#endif
+    return size;
+}
 
-    clear_keyboard();
-    layer_clear();
-    *macro_pointer = macro_buffer;
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+/* The EEPROM holds a version byte, dynamic_macro_used, the slots and
+ * then the whole buffer, which all has to fit in the EEPROM of the MCU.
+ * Only some of the ChibiOS MCUs have an EEPROM emulation that survives a
+ * reboot, and it's small. */
+#ifndef DYNAMIC_MACRO_EEPROM_SIZE
+#    if defined(__AVR__)
+#        define DYNAMIC_MACRO_EEPROM_SIZE (E2END + 1)
+#    elif defined(K20x)
+#        define DYNAMIC_MACRO_EEPROM_SIZE 32
+#    elif defined(KL2x)
+#        define DYNAMIC_MACRO_EEPROM_SIZE 128
+#    elif defined(PROTOCOL_CHIBIOS)
+#        error "DYNAMIC_MACRO_EEPROM_ADDR is not supported, the EEPROM of this MCU is not kept across reboots"
+#    else
+#        error "DYNAMIC_MACRO_EEPROM_SIZE must be set to the EEPROM size of this platform"
+#    endif
+#endif
+
+#if DYNAMIC_MACRO_EEPROM_ADDR + 3 + 4 * DYNAMIC_MACRO_SLOTS + DYNAMIC_MACRO_BYTES > DYNAMIC_MACRO_EEPROM_SIZE
+#error "The dynamic macros don't fit in the EEPROM, lower DYNAMIC_MACRO_SIZE or DYNAMIC_MACRO_EEPROM_ADDR"
+#endif
+
+#define DYNAMIC_MACRO_EEPROM_VERSION 0xD1
+#define DYNAMIC_MACRO_EEPROM_USED ((uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR) + 1)
+#define DYNAMIC_MACRO_EEPROM_SLOTS (DYNAMIC_MACRO_EEPROM_USED + sizeof(dynamic_macro_used))
+#define DYNAMIC_MACRO_EEPROM_BUFFER (DYNAMIC_MACRO_EEPROM_SLOTS + sizeof(dynamic_macro_slots))
+
+void dynamic_macro_save(void)
+{
+    eeprom_update_byte((uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR), DYNAMIC_MACRO_EEPROM_VERSION);
+    eeprom_update_block(&dynamic_macro_used, DYNAMIC_MACRO_EEPROM_USED, sizeof(dynamic_macro_used));
+    eeprom_update_block(dynamic_macro_slots, DYNAMIC_MACRO_EEPROM_SLOTS, sizeof(dynamic_macro_slots));
+    eeprom_update_block(dynamic_macro_buffer, DYNAMIC_MACRO_EEPROM_BUFFER, dynamic_macro_used);
+}
+
+/* Leaves the macros empty when the EEPROM doesn't hold any */
+void dynamic_macro_load(void)
+{
+    dynamic_macro_used = 0;
+    memset(dynamic_macro_slots, 0, sizeof(dynamic_macro_slots));
+    if (eeprom_read_byte((uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR)) != DYNAMIC_MACRO_EEPROM_VERSION) {
+        return;
+    }
+    uint16_t used;
+    eeprom_read_block(&used, DYNAMIC_MACRO_EEPROM_USED, sizeof(used));
+    if (used > DYNAMIC_MACRO_BYTES) {
+        return;
+    }
+    eeprom_read_block(dynamic_macro_slots, DYNAMIC_MACRO_EEPROM_SLOTS, sizeof(dynamic_macro_slots));
+    for (uint8_t i = 0; i < DYNAMIC_MACRO_SLOTS; i++) {
+        if ((uint32_t)dynamic_macro_slots[i].offset + dynamic_macro_slots[i].length > used) {
+            memset(dynamic_macro_slots, 0, sizeof(dynamic_macro_slots));
+            return;
+        }
+    }
+    eeprom_read_block(dynamic_macro_buffer, DYNAMIC_MACRO_EEPROM_BUFFER, used);
+    dynamic_macro_used = used;
+}
+#endif
+
+/* The slot of a record or play key, counting from 1, or 0 */
+static uint8_t dynamic_macro_slot(uint16_t keycode, bool play)
+{
+    if (keycode == (play ? DYN_MACRO_PLAY1 : DYN_REC_START1)) {
+        return 1;
+    }
+    if (keycode == (play ? DYN_MACRO_PLAY2 : DYN_REC_START2)) {
+        return 2;
+    }
+    if (keycode >= DYN_MACRO_SLOT3 && keycode < DYN_MACRO_SLOT3 + (DYNAMIC_MACRO_SLOTS - 2) * 2 &&
+        ((keycode - DYN_MACRO_SLOT3) & 1) == play) {
+        return 3 + (keycode - DYN_MACRO_SLOT3) / 2;
+    }
+    return 0;
 }
 
 /**
- * Play the dynamic macro.
+ * Start recording of the dynamic macro, dropping the one in the slot.
  *
- * @param macro_buffer[in] The beginning of the macro buffer being played.
- * @param macro_end[in]    The element after the last macro buffer element.
- * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
+ * @param slot[in] The slot, counting from 1.
  */
-void dynamic_macro_play(
-    keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction)
+void dynamic_macro_record_start(uint8_t slot)
 {
-    dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
+    dprintln("dynamic macro recording: started");
 
-    uint32_t saved_layer_state = layer_state;
+    dynamic_macro_led_blink();
 
     clear_keyboard();
     layer_clear();
 
-    while (macro_buffer != macro_end) {
-        process_record(macro_buffer);
-        macro_buffer += direction;
+    uint16_t offset = dynamic_macro_slots[slot - 1].offset;
+    uint16_t length = dynamic_macro_slots[slot - 1].length;
+    memmove(&dynamic_macro_buffer[offset], &dynamic_macro_buffer[offset + length],
+        dynamic_macro_used - offset - length);
+    dynamic_macro_used -= length;
+    for (uint8_t i = 0; i < DYNAMIC_MACRO_SLOTS; i++) {
+        if (dynamic_macro_slots[i].length && dynamic_macro_slots[i].offset > offset) {
+            dynamic_macro_slots[i].offset -= length;
+        }
     }
+    dynamic_macro_slots[slot - 1].offset = 0;
+    dynamic_macro_slots[slot - 1].length = 0;
+
+    dynamic_macro_recording = slot;
+    dynamic_macro_record_pointer = dynamic_macro_used;
+    dynamic_macro_record_trimmed_end = dynamic_macro_used;
+    dynamic_macro_record_full = false;
+    dynamic_macro_record_time = timer_read();
+}
+
+/**
+ * Start playing the dynamic macro. The events are played back one per
+ * scan by dynamic_macro_task().
+ *
+ * @param slot[in] The slot, counting from 1.
+ */
+void dynamic_macro_play(uint8_t slot)
+{
+    dprintf("dynamic macro: slot %d playback\n", slot);
+
+    dynamic_macro_saved_layer_state = layer_state;
 
     clear_keyboard();
+    layer_clear();
 
-    layer_state = saved_layer_state;
+    dynamic_macro_playing = slot;
+    dynamic_macro_play_pointer = dynamic_macro_slots[slot - 1].offset;
+    dynamic_macro_play_end = dynamic_macro_play_pointer + dynamic_macro_slots[slot - 1].length;
+    dynamic_macro_play_time = timer_read();
 }
 
 /**
  * Record a single key in a dynamic macro.
  *
- * @param macro_buffer[in] The start of the used macro buffer.
- * @param macro_pointer[in,out] The current buffer position.
- * @param macro2_end[in] The end of the other macro.
- * @param direction[in]  Either +1 or -1, which way to iterate the buffer.
- * @param record[in]     The current keypress.
+ * @param record[in] The current keypress.
  */
-void dynamic_macro_record_key(
-    keyrecord_t *macro_buffer,
-    keyrecord_t **macro_pointer,
-    keyrecord_t *macro2_end,
-    int8_t direction,
-    keyrecord_t *record)
+void dynamic_macro_record_key(keyrecord_t *record)
 {
     /* If we've just started recording, ignore all the key releases. */
-    if (!record->event.pressed && *macro_pointer == macro_buffer) {
+    if (!record->event.pressed && dynamic_macro_record_pointer == dynamic_macro_used) {
         dprintln("dynamic macro: ignoring a leading key-up event");
         return;
     }
 
-    /* The other end of the other macro is the last buffer element it
-     * is safe to use before overwriting the other macro.
-     */
-    if (*macro_pointer - direction != macro2_end) {
-        **macro_pointer = *record;
-        *macro_pointer += direction;
+    uint8_t event[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+    uint8_t size = dynamic_macro_encode_event(event, record,
+        TIMER_DIFF_16(record->event.time, dynamic_macro_record_time));
+    /* Once an event doesn't fit, a later, smaller one could still fit,
+     * and leave a key pressed or released without the other half. */
+    if (!dynamic_macro_record_full && dynamic_macro_record_pointer + size <= DYNAMIC_MACRO_BYTES) {
+        memcpy(&dynamic_macro_buffer[dynamic_macro_record_pointer], event, size);
+        dynamic_macro_record_pointer += size;
+        dynamic_macro_record_time = record->event.time;
+        /* Do not save the keys being held when stopping the recording,
+         * i.e. the keys used to access the layer DYN_REC_STOP is on.
+         */
+        if (!record->event.pressed) {
+            dynamic_macro_record_trimmed_end = dynamic_macro_record_pointer;
+        }
     } else {
+        dynamic_macro_record_full = true;
         dynamic_macro_led_blink();
     }
 
     dprintf(
         "dynamic macro: slot %d length: %d/%d\n",
-        DYNAMIC_MACRO_CURRENT_SLOT(),
-        DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, *macro_pointer),
-        DYNAMIC_MACRO_CURRENT_CAPACITY(macro_buffer, macro2_end));
+        dynamic_macro_recording,
+        dynamic_macro_record_pointer - dynamic_macro_used,
+        DYNAMIC_MACRO_BYTES - dynamic_macro_used);
 }
 
 /**
  * End recording of the dynamic macro. Essentially just update the
- * pointer to the end of the macro.
+ * slot to the recorded range.
  */
-void dynamic_macro_record_end(
-    keyrecord_t *macro_buffer,
-    keyrecord_t *macro_pointer,
-    int8_t direction,
-    keyrecord_t **macro_end)
+void dynamic_macro_record_end(void)
 {
     dynamic_macro_led_blink();
 
-    /* Do not save the keys being held when stopping the recording,
-     * i.e. the keys used to access the layer DYN_REC_STOP is on.
-     */
-    while (macro_pointer != macro_buffer &&
-           (macro_pointer - direction)->event.pressed) {
-        dprintln("dynamic macro: trimming a trailing key-down event");
-        macro_pointer -= direction;
-    }
+    uint8_t slot = dynamic_macro_recording;
+    dynamic_macro_slots[slot - 1].offset = dynamic_macro_used;
+    dynamic_macro_slots[slot - 1].length = dynamic_macro_record_trimmed_end - dynamic_macro_used;
+    dynamic_macro_used = dynamic_macro_record_trimmed_end;
+    dynamic_macro_recording = 0;
 
     dprintf(
         "dynamic macro: slot %d saved, length: %d\n",
-        DYNAMIC_MACRO_CURRENT_SLOT(),
-        DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, macro_pointer));
+        slot, dynamic_macro_slots[slot - 1].length);
+
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+    dynamic_macro_save();
+#endif
+}
+
+/* Plays the next event of the macro being played, called from the
+ * scan loop. With DYNAMIC_MACRO_KEEP_TIMING, the events are as far
+ * apart as when they were recorded. */
+void dynamic_macro_task(void)
+{
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+    static bool loaded = false;
+    if (!loaded) {
+        dynamic_macro_load();
+        loaded = true;
+    }
+#endif
+
+    if (!dynamic_macro_playing) {
+        return;
+    }
 
-    *macro_end = macro_pointer;
+    if (dynamic_macro_play_pointer != dynamic_macro_play_end) {
+        keyrecord_t record = {};
+        uint16_t delay;
+        uint8_t size = dynamic_macro_decode_event(&dynamic_macro_buffer[dynamic_macro_play_pointer], &record, &delay);
+#ifdef DYNAMIC_MACRO_KEEP_TIMING
+        if (timer_elapsed(dynamic_macro_play_time) < delay) {
+            return;
+        }
+#endif
+        dynamic_macro_play_pointer += size;
+        dynamic_macro_play_time = timer_read();
+        record.event.time = dynamic_macro_play_time | 1;
+        process_record(&record);
+        return;
+    }
+
+    clear_keyboard();
+
+    layer_state = dynamic_macro_saved_layer_state;
+    dynamic_macro_playing = 0;
 }
 
 /* Handle the key events related to the dynamic macros. Should be
@@ -189,115 +441,49 @@ void dynamic_macro_record_end(
  */
 bool process_record_dynamic_macro(uint16_t keycode, keyrecord_t *record)
 {
-    /* Both macros use the same buffer but read/write on different
-     * ends of it.
-     *
-     * Macro1 is written left-to-right starting from the beginning of
-     * the buffer.
-     *
-     * Macro2 is written right-to-left starting from the end of the
-     * buffer.
-     *
-     * &macro_buffer   macro_end
-     *  v                   v
-     * +------------------------------------------------------------+
-     * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
-     * +------------------------------------------------------------+
-     *                           ^                                 ^
-     *                         r_macro_end                  r_macro_buffer
-     *
-     * During the recording when one macro encounters the end of the
-     * other macro, the recording is stopped. Apart from this, there
-     * are no arbitrary limits for the macros' length in relation to
-     * each other: for example one can either have two medium sized
-     * macros or one long macro and one short macro. Or even one empty
-     * and one using the whole buffer.
-     */
-    static keyrecord_t macro_buffer[DYNAMIC_MACRO_SIZE];
-
-    /* Pointer to the first buffer element after the first macro.
-     * Initially points to the very beginning of the buffer since the
-     * macro is empty. */
-    static keyrecord_t *macro_end = macro_buffer;
-
-    /* The other end of the macro buffer. Serves as the beginning of
-     * the second macro. */
-    static keyrecord_t *const r_macro_buffer = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
-
-    /* Like macro_end but for the second macro. */
-    static keyrecord_t *r_macro_end = r_macro_buffer;
-
-    /* A persistent pointer to the current macro position (iterator)
-     * used during the recording. */
-    static keyrecord_t *macro_pointer = NULL;
-
-    /* 0   - no macro is being recorded right now
-     * 1,2 - either macro 1 or 2 is being recorded */
-    static uint8_t macro_id = 0;
-
-    if (macro_id == 0) {
+    uint8_t slot;
+
+    if (dynamic_macro_recording == 0) {
         /* No macro recording in progress. */
         if (!record->event.pressed) {
-            switch (keycode) {
-            case DYN_REC_START1:
-                dynamic_macro_record_start(&macro_pointer, macro_buffer);
-                macro_id = 1;
-                return false;
-            case DYN_REC_START2:
-                dynamic_macro_record_start(&macro_pointer, r_macro_buffer);
-                macro_id = 2;
-                return false;
-            case DYN_MACRO_PLAY1:
-                dynamic_macro_play(macro_buffer, macro_end, +1);
+            if ((slot = dynamic_macro_slot(keycode, false))) {
+                if (dynamic_macro_playing) {
+                    dprintln("dynamic macro: ignoring macro record key while playing");
+                } else {
+                    dynamic_macro_record_start(slot);
+                }
                 return false;
-            case DYN_MACRO_PLAY2:
-                dynamic_macro_play(r_macro_buffer, r_macro_end, -1);
+            }
+            if ((slot = dynamic_macro_slot(keycode, true))) {
+                if (dynamic_macro_playing) {
+                    dprintln("dynamic macro: ignoring macro play key while playing");
+                } else {
+                    dynamic_macro_play(slot);
+                }
                 return false;
             }
         }
     } else {
         /* A macro is being recorded right now. */
-        switch (keycode) {
-        case DYN_REC_STOP:
+        if (keycode == DYN_REC_STOP) {
             /* Stop the macro recording. */
             if (record->event.pressed) { /* Ignore the initial release
                                           * just after the recoding
                                           * starts. */
-                switch (macro_id) {
-                case 1:
-                    dynamic_macro_record_end(macro_buffer, macro_pointer, +1, &macro_end);
-                    break;
-                case 2:
-                    dynamic_macro_record_end(r_macro_buffer, macro_pointer, -1, &r_macro_end);
-                    break;
-                }
-                macro_id = 0;
+                dynamic_macro_record_end();
             }
             return false;
-        case DYN_MACRO_PLAY1:
-        case DYN_MACRO_PLAY2:
+        }
+        if (dynamic_macro_slot(keycode, true)) {
             dprintln("dynamic macro: ignoring macro play key while recording");
             return false;
-        default:
-            /* Store the key in the macro buffer and process it normally. */
-            switch (macro_id) {
-            case 1:
-                dynamic_macro_record_key(macro_buffer, &macro_pointer, r_macro_end, +1, record);
-                break;
-            case 2:
-                dynamic_macro_record_key(r_macro_buffer, &macro_pointer, macro_end, -1, record);
-                break;
-            }
-            return true;
-            break;
         }
+        /* Store the key in the macro buffer and process it normally. */
+        dynamic_macro_record_key(record);
+        return true;
     }
 
     return true;
 }
 
-#undef DYNAMIC_MACRO_CURRENT_SLOT
-#undef DYNAMIC_MACRO_CURRENT_LENGTH
-#undef DYNAMIC_MACRO_CURRENT_CAPACITY
-
 #endif
@@ -40,14 +40,33 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "quantum_keycodes.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // translates key to keycode
 uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
 
 // translates function id to action
 uint16_t keymap_function_id_to_action( uint16_t function_id );
 
+// translates keycode to action
+action_t action_for_keycode(uint16_t keycode);
+
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
 extern const uint16_t fn_actions[];
 
+// Action table entry of keycodes which depend on the keymap config or
+// fn_actions, those are decoded with action_for_keycode() at runtime
+#define KEYMAP_ACTION_DECODE 0x7FFF
+
+#ifdef KEYMAP_ACTION_TABLE
+// keymaps translated to actions, generated by keymap_action_table.mk
+extern const uint16_t keymap_actions[];
+#endif
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
@@ -0,0 +1,51 @@
+# Translates the keymaps to actions at build time, see KEYMAP_ACTION_TABLE
+# in docs/config_options.md
+#
+# The including makefile sets
+#   KEYMAP_ACTION_TABLE_OUTPUT - the output that the keymap is compiled into
+#   KEYMAP_ACTION_TABLE_KEYMAP - the keymap.c that defines the keymaps
+
+HOST_CC ?= gcc
+KEYMAP_ACTION_TABLE_OBJCOPY := $(if $(strip $(OBJCOPY)),$(OBJCOPY),objcopy)
+
+KEYMAP_ACTION_TABLE_DIR := $(KEYMAP_ACTION_TABLE_OUTPUT)/keymap_action_table
+KEYMAP_ACTION_TABLE_TOOL := $(KEYMAP_ACTION_TABLE_DIR)/keymap_action_table
+KEYMAP_ACTION_TABLE_BIN := $(KEYMAP_ACTION_TABLE_DIR)/keymaps.bin
+KEYMAP_ACTION_TABLE_C := $(KEYMAP_ACTION_TABLE_DIR)/keymap_actions.c
+KEYMAP_ACTION_TABLE_O := $(KEYMAP_ACTION_TABLE_DIR)/keymap_actions.o
+KEYMAP_ACTION_TABLE_KEYMAP_O := $(KEYMAP_ACTION_TABLE_OUTPUT)/$(patsubst %.c,%.o,$(KEYMAP_ACTION_TABLE_KEYMAP))
+
+KEYMAP_ACTION_TABLE_TOOL_SRC := \
+	$(QUANTUM_DIR)/tools/keymap_action_table.c \
+	$(QUANTUM_DIR)/keymap_action.c \
+	$(QUANTUM_DIR)/keycode_config.c
+
+# The tool only needs the feature defines, the matrix size is irrelevant for
+# translating single keycodes
+KEYMAP_ACTION_TABLE_TOOL_FLAGS := \
+	$(filter -D%,$(OPT_DEFS)) \
+	-DMATRIX_ROWS=1 -DMATRIX_COLS=1 \
+	-I$(QUANTUM_DIR) -I$(QUANTUM_DIR)/keymap_extras -I$(TMK_DIR)/common
+
+$(KEYMAP_ACTION_TABLE_OUTPUT)_OBJ += $(KEYMAP_ACTION_TABLE_O)
+
+$(KEYMAP_ACTION_TABLE_TOOL): $(KEYMAP_ACTION_TABLE_TOOL_SRC) | $(BEGIN)
+	@mkdir -p $(@D)
+	@$(SILENT) || printf "$(MSG_COMPILING) $@" | $(AWK_CMD)
+	$(eval CMD=$(HOST_CC) -std=gnu99 -O2 $(KEYMAP_ACTION_TABLE_TOOL_FLAGS) $^ -o $@)
+	@$(BUILD_CMD)
+
+# The keymaps are extracted from their own data section
+$(KEYMAP_ACTION_TABLE_BIN): $(KEYMAP_ACTION_TABLE_KEYMAP_O)
+	@mkdir -p $(@D)
+	@$(KEYMAP_ACTION_TABLE_OBJCOPY) -O binary --only-section='*.keymaps' $< $@
+
+$(KEYMAP_ACTION_TABLE_C): $(KEYMAP_ACTION_TABLE_BIN) $(KEYMAP_ACTION_TABLE_TOOL)
+	@$(SILENT) || printf "Generating: $@" | $(AWK_CMD)
+	$(eval CMD=$(KEYMAP_ACTION_TABLE_TOOL) < $< > $@ || (rm -f $@; false))
+	@$(BUILD_CMD)
+
+$(KEYMAP_ACTION_TABLE_O): $(KEYMAP_ACTION_TABLE_C)
+	@$(SILENT) || printf "$(MSG_COMPILING) $<" | $(AWK_CMD)
+	$(eval CMD=$(CC) -c $($(KEYMAP_ACTION_TABLE_OUTPUT)_CFLAGS) $< -o $@)
+	@$(BUILD_CMD)
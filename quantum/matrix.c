@@ -25,18 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "matrix.h"
 #include "timer.h"
-
-
-/* Set 0 if debouncing isn't needed */
-
-#ifndef DEBOUNCING_DELAY
-#   define DEBOUNCING_DELAY 5
-#endif
-
-#if (DEBOUNCING_DELAY > 0)
-    static uint16_t debouncing_time;
-    static bool debouncing = false;
-#endif
+#include "debounce.h"
 
 #if (MATRIX_COLS <= 8)
 #    define print_matrix_header()  print("\nr/c 01234567\n")
@@ -69,6 +58,9 @@ static matrix_row_t matrix[MATRIX_ROWS];
 
 static matrix_row_t matrix_debouncing[MATRIX_ROWS];
 
+/* rows of matrix[] changed since the last matrix_changed_rows() */
+static matrix_changed_t rows_changed;
+
 
 #if (DIODE_DIRECTION == COL2ROW)
     static void init_cols(void);
@@ -168,27 +160,31 @@ void matrix_init(void) {
         matrix[i] = 0;
         matrix_debouncing[i] = 0;
     }
+    rows_changed = 0;
+
+#if (DEBOUNCING_DELAY > 0)
+    debounce_init(MATRIX_ROWS);
+#endif
 
     matrix_init_quantum();
 }
 
 uint8_t matrix_scan(void)
 {
+#if (DEBOUNCING_DELAY > 0)
+    bool matrix_changed = false;
+#endif
 
 #if (DIODE_DIRECTION == COL2ROW)
 
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < MATRIX_ROWS; current_row++) {
 #       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_cols_on_row(matrix_debouncing, current_row);
-
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
-            }
-
+            matrix_changed |= read_cols_on_row(matrix_debouncing, current_row);
 #       else
-            read_cols_on_row(matrix, current_row);
+            if (read_cols_on_row(matrix, current_row)) {
+                rows_changed |= ((matrix_changed_t)1 << current_row);
+            }
 #       endif
 
     }
@@ -198,13 +194,12 @@ uint8_t matrix_scan(void)
     // Set col, read rows
     for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++) {
 #       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_rows_on_col(matrix_debouncing, current_col);
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
-            }
+            matrix_changed |= read_rows_on_col(matrix_debouncing, current_col);
 #       else
-             read_rows_on_col(matrix, current_col);
+            // a column read touches every row, so don't try to narrow it down
+            if (read_rows_on_col(matrix, current_col)) {
+                rows_changed = MATRIX_CHANGED_ALL;
+            }
 #       endif
 
     }
@@ -212,26 +207,30 @@ uint8_t matrix_scan(void)
 #endif
 
 #   if (DEBOUNCING_DELAY > 0)
-        if (debouncing && (timer_elapsed(debouncing_time) > DEBOUNCING_DELAY)) {
-            for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-                matrix[i] = matrix_debouncing[i];
-            }
-            debouncing = false;
-        }
+        rows_changed |= debounce(matrix_debouncing, matrix, MATRIX_ROWS, matrix_changed);
 #   endif
 
+#ifndef KEYEVENT_SCAN_THREAD
     matrix_scan_quantum();
+#endif
     return 1;
 }
 
 bool matrix_is_modified(void)
 {
 #if (DEBOUNCING_DELAY > 0)
-    if (debouncing) return false;
+    if (debounce_active()) return false;
 #endif
     return true;
 }
 
+matrix_changed_t matrix_changed_rows(void)
+{
+    matrix_changed_t changed = rows_changed;
+    rows_changed = 0;
+    return changed;
+}
+
 inline
 bool matrix_is_on(uint8_t row, uint8_t col)
 {
@@ -0,0 +1,180 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "quantum.h"
+#include "process_dispatch.h"
+
+#ifndef PROCESS_DISPATCH_MAX_SEGMENTS
+#define PROCESS_DISPATCH_MAX_SEGMENTS 32
+#endif
+
+/* The order of the chain, the first handler to return false stops it */
+static const process_handler_t * const handlers[] = {
+#if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
+    &process_midi_handler,
+#endif
+#ifdef AUDIO_ENABLE
+    &process_audio_handler,
+#endif
+#ifdef STENO_ENABLE
+    &process_steno_handler,
+#endif
+#if defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))
+    &process_music_handler,
+#endif
+#ifdef TAP_DANCE_ENABLE
+    &process_tap_dance_handler,
+#endif
+#ifndef DISABLE_LEADER
+    &process_leader_handler,
+#endif
+#ifndef DISABLE_CHORDING
+    &process_chording_handler,
+#endif
+#ifdef COMBO_ENABLE
+    &process_combo_handler,
+#endif
+#ifdef UNICODE_ENABLE
+    &process_unicode_handler,
+#endif
+#ifdef UCIS_ENABLE
+    &process_ucis_handler,
+#endif
+#ifdef PRINTING_ENABLE
+    &process_printer_handler,
+#endif
+#ifdef AUTO_SHIFT_ENABLE
+    &process_auto_shift_handler,
+#endif
+#ifdef UNICODEMAP_ENABLE
+    &process_unicode_map_handler,
+#endif
+#ifdef TERMINAL_ENABLE
+    &process_terminal_handler,
+#endif
+    NULL
+};
+
+#define HANDLER_COUNT (sizeof(handlers) / sizeof(handlers[0]) - 1)
+#define ALL_HANDLERS ((process_handler_mask_t)(((uint32_t)1 << HANDLER_COUNT) - 1))
+
+/*
+ * The keycode space split into segments, sorted by their first keycode.
+ * Every keycode in a segment is wanted by the same handlers.
+ */
+static uint16_t segment_start[PROCESS_DISPATCH_MAX_SEGMENTS];
+static process_handler_mask_t segment_handlers[PROCESS_DISPATCH_MAX_SEGMENTS];
+static uint8_t segment_count;
+static process_handler_mask_t handlers_with_active;
+
+static void add_segment_start(uint16_t start) {
+    uint8_t i = segment_count;
+    while (i > 0 && segment_start[i - 1] > start) {
+        i--;
+    }
+    if (i > 0 && segment_start[i - 1] == start) {
+        return;
+    }
+    if (segment_count < PROCESS_DISPATCH_MAX_SEGMENTS) {
+        for (uint8_t j = segment_count; j > i; j--) {
+            segment_start[j] = segment_start[j - 1];
+        }
+        segment_start[i] = start;
+    }
+    // Count it anyway, build_index notices that it doesn't fit
+    segment_count++;
+}
+
+static void build_index(void) {
+    segment_count = 0;
+    handlers_with_active = 0;
+    add_segment_start(0);
+    for (uint8_t h = 0; h < HANDLER_COUNT; h++) {
+        for (uint8_t r = 0; r < handlers[h]->range_count; r++) {
+            const process_range_t *range = &handlers[h]->ranges[r];
+            add_segment_start(range->first);
+            if (range->last != 0xFFFF) {
+                add_segment_start(range->last + 1);
+            }
+        }
+        if (handlers[h]->active) {
+            handlers_with_active |= (process_handler_mask_t)1 << h;
+        }
+    }
+
+    if (segment_count > PROCESS_DISPATCH_MAX_SEGMENTS) {
+        // Doesn't fit, every keycode goes to every handler
+        segment_count = 1;
+        segment_handlers[0] = ALL_HANDLERS;
+        return;
+    }
+
+    for (uint8_t s = 0; s < segment_count; s++) {
+        process_handler_mask_t mask = 0;
+        for (uint8_t h = 0; h < HANDLER_COUNT; h++) {
+            for (uint8_t r = 0; r < handlers[h]->range_count; r++) {
+                const process_range_t *range = &handlers[h]->ranges[r];
+                if (segment_start[s] >= range->first && segment_start[s] <= range->last) {
+                    mask |= (process_handler_mask_t)1 << h;
+                    break;
+                }
+            }
+        }
+        segment_handlers[s] = mask;
+    }
+}
+
+static process_handler_mask_t handlers_for_keycode(uint16_t keycode) {
+    if (segment_count == 0) {
+        build_index();
+    }
+    // Find the last segment that starts at or before the keycode
+    uint8_t lo = 0;
+    uint8_t hi = segment_count - 1;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi + 1) / 2;
+        if (segment_start[mid] <= keycode) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return segment_handlers[lo];
+}
+
+process_handler_mask_t process_dispatch_handlers(uint16_t keycode) {
+    process_handler_mask_t mask = handlers_for_keycode(keycode);
+    process_handler_mask_t maybe_active = handlers_with_active & ~mask;
+    for (uint8_t h = 0; maybe_active; h++, maybe_active >>= 1) {
+        if ((maybe_active & 1) && handlers[h]->active()) {
+            mask |= (process_handler_mask_t)1 << h;
+        }
+    }
+    return mask;
+}
+
+bool process_dispatch(uint16_t keycode, keyrecord_t *record) {
+    process_handler_mask_t mask = process_dispatch_handlers(keycode);
+    for (uint8_t h = 0; mask; h++, mask >>= 1) {
+        if ((mask & 1) && !handlers[h]->process(keycode, record)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint8_t process_dispatch_handler_count(void) {
+    return HANDLER_COUNT;
+}
@@ -0,0 +1,70 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PROCESS_DISPATCH_H
+#define PROCESS_DISPATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "action.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An inclusive range of keycodes */
+typedef struct {
+    uint16_t first;
+    uint16_t last;
+} process_range_t;
+
+/*
+ * A process_* module that takes part in process_record_quantum().
+ *
+ * The handler only sees the keycodes in its ranges, unless active() returns
+ * true, for example while the leader key or music mode is active. Then it
+ * sees every keycode. active can be NULL.
+ */
+typedef struct {
+    bool (*process)(uint16_t keycode, keyrecord_t *record);
+    bool (*active)(void);
+    const process_range_t *ranges;
+    uint8_t range_count;
+} process_handler_t;
+
+#define PROCESS_HANDLER(process, active, ranges) \
+    { (process), (active), (ranges), sizeof(ranges) / sizeof((ranges)[0]) }
+
+/* Use as the only range of handlers that need to see every keycode */
+#define PROCESS_RANGE_ALL { 0x0000, 0xFFFF }
+
+/* One bit per registered handler, in chain order */
+typedef uint16_t process_handler_mask_t;
+
+/* Calls the handlers that want the keycode, in chain order, until one of
+ * them returns false. */
+bool process_dispatch(uint16_t keycode, keyrecord_t *record);
+
+/* The handlers that process_dispatch() would call for the keycode */
+process_handler_mask_t process_dispatch_handlers(uint16_t keycode);
+
+/* The number of registered handlers */
+uint8_t process_dispatch_handler_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
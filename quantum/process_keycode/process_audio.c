@@ -65,4 +65,11 @@ void process_audio_all_notes_off(void) {
 }
 
 __attribute__ ((weak))
-void audio_on_user() {}
\ No newline at end of file
+void audio_on_user() {}
+
+static const process_range_t process_audio_ranges[] = {
+    { AU_ON, AU_TOG },
+    { MUV_IN, MUV_DE },
+};
+
+const process_handler_t process_audio_handler = PROCESS_HANDLER(process_audio, NULL, process_audio_ranges);
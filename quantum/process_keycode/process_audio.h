@@ -2,6 +2,7 @@
 #define PROCESS_AUDIO_H
 
 bool process_audio(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_audio_handler;
 void process_audio_noteon(uint8_t note);
 void process_audio_noteoff(uint8_t note);
 void process_audio_all_notes_off(void);
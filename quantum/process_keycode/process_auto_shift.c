@@ -30,41 +30,180 @@
   unregister_code(key); \
   unregister_code(mod)
 
-uint16_t autoshift_time = 0;
 uint16_t autoshift_timeout = AUTO_SHIFT_TIMEOUT;
-uint16_t autoshift_lastkey = KC_NO;
+
+/* The auto shifted keys that were pressed but not released yet, oldest
+ * first. Each one is settled on its own, when it is released or held past
+ * its timeout, but they are sent in the order they were pressed. */
+typedef struct {
+  uint16_t keycode;
+  keypos_t key;
+  uint16_t time;
+  bool settled;
+  bool shifted;
+  bool sent;
+  bool released;
+} autoshift_pending_t;
+
+static autoshift_pending_t autoshift_queue[AUTO_SHIFT_QUEUE_SIZE];
+static uint8_t autoshift_queue_count;
+
+/* How long the keys were held, for tuning the timeout */
+static uint32_t autoshift_tap_time_total;
+static uint16_t autoshift_tap_count;
+static uint32_t autoshift_hold_time_total;
+static uint16_t autoshift_hold_count;
+
+#ifdef AUTO_SHIFT_TIMEOUT_PER_KEY
+__attribute__ ((weak))
+uint16_t get_auto_shift_timeout(uint16_t keycode) {
+  return autoshift_timeout;
+}
+#  define GET_AUTO_SHIFT_TIMEOUT(keycode) get_auto_shift_timeout(keycode)
+#else
+#  define GET_AUTO_SHIFT_TIMEOUT(keycode) autoshift_timeout
+#endif
+
+static uint16_t average(uint32_t total, uint16_t count) {
+  return count ? total / count : 0;
+}
+
+uint16_t autoshift_average_tap_time(void) {
+  return average(autoshift_tap_time_total, autoshift_tap_count);
+}
+
+uint16_t autoshift_average_hold_time(void) {
+  return average(autoshift_hold_time_total, autoshift_hold_count);
+}
+
+void autoshift_reset_hold_times(void) {
+  autoshift_tap_time_total = 0;
+  autoshift_tap_count = 0;
+  autoshift_hold_time_total = 0;
+  autoshift_hold_count = 0;
+}
+
+/* Keeps the average, by halving both before the count overflows */
+static void add_hold_time(uint32_t *total, uint16_t *count, uint16_t held) {
+  if (*count == UINT16_MAX) {
+    *total /= 2;
+    *count /= 2;
+  }
+  *total += held;
+  (*count)++;
+}
 
 void autoshift_timer_report(void) {
-  char display[8];
+  char display[32];
 
-  snprintf(display, 8, "\n%d\n", autoshift_timeout);
+  snprintf(display, sizeof(display), "\n%d\n%d %d\n", autoshift_timeout,
+    autoshift_average_tap_time(), autoshift_average_hold_time());
 
   send_string((const char *)display);
 }
 
-void autoshift_on(uint16_t keycode) {
-  autoshift_time = timer_read();
-  autoshift_lastkey = keycode;
+static void autoshift_settle(autoshift_pending_t *pending) {
+  uint16_t elapsed = timer_elapsed(pending->time);
+
+  pending->settled = true;
+  pending->shifted = elapsed > GET_AUTO_SHIFT_TIMEOUT(pending->keycode);
 }
 
-void autoshift_flush(void) {
-  if (autoshift_lastkey != KC_NO) {
-    uint16_t elapsed = timer_elapsed(autoshift_time);
+static void autoshift_send(autoshift_pending_t *pending) {
+  if (pending->shifted) {
+    TAP_WITH_MOD(KC_LSFT, pending->keycode);
+  } else {
+    TAP(pending->keycode);
+  }
+}
 
-    if (elapsed > autoshift_timeout) {
-      register_code(KC_LSFT);
+/* Sends the settled keys that are not behind an unsettled one, and with
+ * force, the rest too, settled by how long they have been held so far.
+ * Then drops the keys that were sent and released. */
+static void autoshift_send_settled(bool force) {
+  uint8_t kept = 0;
+  bool blocked = false;
+
+  for (uint8_t i = 0; i < autoshift_queue_count; i++) {
+    autoshift_pending_t *pending = &autoshift_queue[i];
+    if (!pending->sent && !blocked) {
+      if (!pending->settled && force) {
+        autoshift_settle(pending);
+      }
+      if (pending->settled) {
+        autoshift_send(pending);
+        pending->sent = true;
+      } else {
+        blocked = true;
+      }
+    }
+    if (!pending->sent || !pending->released) {
+      autoshift_queue[kept++] = *pending;
     }
+  }
+  autoshift_queue_count = kept;
+}
 
-    register_code(autoshift_lastkey);
-    unregister_code(autoshift_lastkey);
+void autoshift_on(uint16_t keycode, keyrecord_t *record) {
+  if (autoshift_queue_count == AUTO_SHIFT_QUEUE_SIZE) {
+    /* Make room by settling the oldest key now, and forgetting the ones
+     * that are only waiting for their release */
+    autoshift_pending_t *oldest = &autoshift_queue[0];
+    if (!oldest->settled) {
+      autoshift_settle(oldest);
+    }
+    autoshift_send_settled(false);
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < autoshift_queue_count; i++) {
+      if (!autoshift_queue[i].sent) {
+        autoshift_queue[kept++] = autoshift_queue[i];
+      }
+    }
+    autoshift_queue_count = kept;
+  }
+  autoshift_queue[autoshift_queue_count++] = (autoshift_pending_t){
+    .keycode = keycode,
+    .key = record->event.key,
+    .time = timer_read(),
+  };
+}
 
-    if (elapsed > autoshift_timeout) {
-      unregister_code(KC_LSFT);
+/* Settles the key that was released, if it is still waiting */
+static void autoshift_release(keyrecord_t *record) {
+  for (uint8_t i = 0; i < autoshift_queue_count; i++) {
+    autoshift_pending_t *pending = &autoshift_queue[i];
+    if (!pending->released && KEYEQ(pending->key, record->event.key)) {
+      uint16_t held = timer_elapsed(pending->time);
+      if (!pending->settled) {
+        autoshift_settle(pending);
+      }
+      if (pending->shifted) {
+        add_hold_time(&autoshift_hold_time_total, &autoshift_hold_count, held);
+      } else {
+        add_hold_time(&autoshift_tap_time_total, &autoshift_tap_count, held);
+      }
+      pending->released = true;
+      autoshift_send_settled(false);
+      return;
     }
+  }
+}
+
+void autoshift_flush(void) {
+  autoshift_send_settled(true);
+}
 
-    autoshift_time = 0;
-    autoshift_lastkey = KC_NO;
+void matrix_scan_auto_shift(void) {
+  if (!autoshift_queue_count) {
+    return;
+  }
+  for (uint8_t i = 0; i < autoshift_queue_count; i++) {
+    autoshift_pending_t *pending = &autoshift_queue[i];
+    if (!pending->settled && timer_elapsed(pending->time) > GET_AUTO_SHIFT_TIMEOUT(pending->keycode)) {
+      autoshift_settle(pending);
+    }
   }
+  autoshift_send_settled(false);
 }
 
 bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
@@ -137,8 +276,6 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
       case KC_DOT:
       case KC_SLSH:
 #endif
-        autoshift_flush();
-
         any_mod_pressed = get_mods() & (
           MOD_BIT(KC_LGUI)|MOD_BIT(KC_RGUI)|
           MOD_BIT(KC_LALT)|MOD_BIT(KC_RALT)|
@@ -147,10 +284,11 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
         );
 
         if (any_mod_pressed) {
+          autoshift_flush();
           return true;
         }
 
-        autoshift_on(keycode);
+        autoshift_on(keycode, record);
         return false;
 
       default:
@@ -158,10 +296,32 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
         return true;
     }
   } else {
-    autoshift_flush();
+    autoshift_release(record);
   }
 
   return true;
 }
 
+static bool auto_shift_active(void) {
+  return autoshift_queue_count;
+}
+
+static const process_range_t process_auto_shift_ranges[] = {
+#ifndef NO_AUTO_SHIFT_ALPHA
+  { KC_A, KC_Z },
+#endif
+#ifndef NO_AUTO_SHIFT_NUMERIC
+  { KC_1, KC_0 },
+#endif
+#ifndef NO_AUTO_SHIFT_SPECIAL
+  { KC_TAB, KC_TAB },
+  { KC_MINUS, KC_BSLS },
+  { KC_SCLN, KC_QUOT },
+  { KC_COMM, KC_SLSH },
+#endif
+  { KC_ASUP, KC_ASRP },
+};
+
+const process_handler_t process_auto_shift_handler = PROCESS_HANDLER(process_auto_shift, auto_shift_active, process_auto_shift_ranges);
+
 #endif
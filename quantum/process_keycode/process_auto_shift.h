@@ -23,6 +23,30 @@
   #define AUTO_SHIFT_TIMEOUT 175
 #endif
 
+/* How many pressed keys can wait to be settled as shifted or not */
+#ifndef AUTO_SHIFT_QUEUE_SIZE
+  #define AUTO_SHIFT_QUEUE_SIZE 4
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 bool process_auto_shift(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_auto_shift_handler;
+void matrix_scan_auto_shift(void);
+
+#ifdef AUTO_SHIFT_TIMEOUT_PER_KEY
+uint16_t get_auto_shift_timeout(uint16_t keycode);
+#endif
+
+/* How long the keys that came out unshifted and shifted were held, on average */
+uint16_t autoshift_average_tap_time(void);
+uint16_t autoshift_average_hold_time(void);
+void autoshift_reset_hold_times(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
@@ -74,3 +74,9 @@ bool process_chording(uint16_t keycode, keyrecord_t *record) {
   }
   return true;
 }
+
+static const process_range_t process_chording_ranges[] = {
+  { QK_CHORDING, QK_CHORDING_MAX },
+};
+
+const process_handler_t process_chording_handler = PROCESS_HANDLER(process_chording, NULL, process_chording_ranges);
@@ -28,5 +28,6 @@ uint8_t chord_key_count = 0;
 uint8_t chord_key_down = 0;
 
 bool process_chording(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_chording_handler;
 
 #endif
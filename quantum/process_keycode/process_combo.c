@@ -16,15 +16,15 @@
 
 #include "process_combo.h"
 #include "print.h"
+#include "debug.h"
+#include <string.h>
 
 
 #define COMBO_TIMER_ELAPSED -1
 
 
 __attribute__ ((weak))
-combo_t key_combos[] = {
-
-};
+combo_t key_combos[COMBO_COUNT];
 
 __attribute__ ((weak))
 void process_combo_event(uint8_t combo_index, bool pressed) {
@@ -46,24 +46,119 @@ static inline void send_combo(uint16_t action, bool pressed)
     }
 }
 
-#define ALL_COMBO_KEYS_ARE_DOWN     (((1<<count)-1) == combo->state)
-#define NO_COMBO_KEYS_ARE_DOWN      (0 == combo->state)
-#define KEY_STATE_DOWN(key)         do{ combo->state |= (1<<key); } while(0)
-#define KEY_STATE_UP(key)           do{ combo->state &= ~(1<<key); } while(0)
-static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record) 
+/* The combos each keycode is part of, sorted by keycode and then combo, so
+ * that a key only visits its own combos, in the same order as before. The
+ * keycode is read back from the combo's keys in flash, so an entry only
+ * takes 2 bytes of RAM. */
+typedef struct {
+    uint8_t combo;
+    uint8_t key;
+} combo_index_entry_t;
+
+static combo_index_entry_t combo_index[COMBO_INDEX_SIZE];
+static uint16_t combo_index_count;
+/* The entries all the combo keys take, to size COMBO_INDEX_SIZE by */
+static uint16_t combo_index_needed;
+static bool combo_index_built;
+/* The combos that didn't fit in the index, they are scanned one by one */
+static uint8_t combo_unindexed[(COMBO_COUNT + 7) / 8];
+static bool combo_index_full;
+/* Zero for the combos that are too long to track */
+static uint8_t combo_length[COMBO_COUNT];
+static bool combo_timer_running;
+
+static inline uint16_t combo_index_keycode(uint16_t i)
+{
+    return pgm_read_word(&key_combos[combo_index[i].combo].keys[combo_index[i].key]);
+}
+
+/* Returns the first entry that doesn't sort before (keycode, combo) */
+static uint16_t combo_index_search(uint16_t keycode, uint8_t combo)
+{
+    uint16_t low = 0;
+    uint16_t high = combo_index_count;
+    while (low < high) {
+        uint16_t mid = (low + high) / 2;
+        uint16_t entry_keycode = combo_index_keycode(mid);
+        if (entry_keycode < keycode || (entry_keycode == keycode && combo_index[mid].combo < combo)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void combo_index_add(uint16_t keycode, uint8_t combo, uint8_t key)
 {
-    uint8_t count = 0;
-    uint8_t index = -1;
-    /* Find index of keycode and number of combo keys */
-    for (const uint16_t *keys = combo->keys; ;++count) {
-        uint16_t key = pgm_read_word(&keys[count]);
-        if (keycode == key) index = count;
-        if (COMBO_END == key) break;
+    uint16_t i = combo_index_search(keycode, combo);
+    if (i < combo_index_count && combo_index_keycode(i) == keycode && combo_index[i].combo == combo) {
+        /* Repeated in the same combo, the last one counts */
+        combo_index[i].key = key;
+        return;
     }
+    memmove(&combo_index[i + 1], &combo_index[i], (combo_index_count - i) * sizeof(combo_index_entry_t));
+    combo_index[i] = (combo_index_entry_t){.combo = combo, .key = key};
+    combo_index_count++;
+}
 
-    /* Return if not a combo key */
-    if (-1 == (int8_t)index) return false;
+void combo_index_build(void)
+{
+    combo_index_count = 0;
+    combo_index_needed = 0;
+    combo_index_full = false;
+    memset(combo_unindexed, 0, sizeof(combo_unindexed));
+    for (uint8_t i = 0; i < COMBO_COUNT; ++i) {
+        const uint16_t *keys = key_combos[i].keys;
+        uint8_t count = 0;
+        while (count <= COMBO_MAX_LENGTH && COMBO_END != pgm_read_word(&keys[count])) {
+            ++count;
+        }
+        if (count > COMBO_MAX_LENGTH) {
+            dprintf("combo %u has more than COMBO_MAX_LENGTH keys\n", i);
+            count = 0;
+        }
+        combo_length[i] = count;
+        combo_index_needed += count;
+        /* A combo is indexed with all its keys or not at all */
+        if (combo_index_count + count > COMBO_INDEX_SIZE) {
+            combo_unindexed[i / 8] |= 1 << (i % 8);
+            combo_index_full = true;
+            continue;
+        }
+        for (uint8_t key = 0; key < count; ++key) {
+            combo_index_add(pgm_read_word(&keys[key]), i, key);
+        }
+    }
+    if (combo_index_full) {
+        dprintf("combo index full, some combos are scanned one by one, set COMBO_INDEX_SIZE to %u\n", combo_index_needed);
+    }
+    combo_index_built = true;
+}
 
+static bool all_combo_keys_are_down(const combo_t *combo, uint8_t count)
+{
+    uint8_t i = 0;
+    for (; count >= 8; count -= 8) {
+        if (combo->state[i++] != 0xFF) return false;
+    }
+    return !count || combo->state[i] == (1 << count) - 1;
+}
+
+static bool no_combo_keys_are_down(const combo_t *combo)
+{
+    for (uint8_t i = 0; i < sizeof(combo->state); ++i) {
+        if (combo->state[i]) return false;
+    }
+    return true;
+}
+
+#define ALL_COMBO_KEYS_ARE_DOWN     all_combo_keys_are_down(combo, count)
+#define NO_COMBO_KEYS_ARE_DOWN      no_combo_keys_are_down(combo)
+#define KEY_STATE_DOWN(key)         do{ combo->state[(key) / 8] |= (1<<((key) % 8)); } while(0)
+#define KEY_STATE_UP(key)           do{ combo->state[(key) / 8] &= ~(1<<((key) % 8)); } while(0)
+static bool process_single_combo(combo_t *combo, uint8_t index, uint8_t count, uint16_t keycode, keyrecord_t *record) 
+{
     /* The combos timer is used to signal whether the combo is active */
     bool is_combo_active = COMBO_TIMER_ELAPSED == combo->timer ? false : true;
 
@@ -76,6 +171,7 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
                 combo->timer = COMBO_TIMER_ELAPSED;
             } else { /* Combo key was pressed */
                 combo->timer = timer_read();
+                combo_timer_running = true;
 #ifdef COMBO_ALLOW_ACTION_KEYS
                 combo->prev_record = *record;
 #else
@@ -116,16 +212,51 @@ bool process_combo(uint16_t keycode, keyrecord_t *record)
 {
     bool is_combo_key = false;
 
-    for (current_combo_index = 0; current_combo_index < COMBO_COUNT; ++current_combo_index) {
+    if (!combo_index_built) {
+        combo_index_build();
+    }
+
+    /* The indexed combos of the key, and the ones that didn't fit in between,
+     * in combo order */
+    uint16_t i = combo_index_search(keycode, 0);
+    uint16_t unindexed = 0;
+    for (;;) {
+        uint16_t next = i < combo_index_count && combo_index_keycode(i) == keycode ? combo_index[i].combo : COMBO_COUNT;
+        for (; combo_index_full && unindexed < next; ++unindexed) {
+            if (!(combo_unindexed[unindexed / 8] & (1 << (unindexed % 8)))) {
+                continue;
+            }
+            current_combo_index = unindexed;
+            combo_t *combo = &key_combos[current_combo_index];
+            uint8_t count = combo_length[current_combo_index];
+            /* Find index of keycode */
+            uint8_t index = count;
+            for (uint8_t k = 0; k < count; ++k) {
+                if (keycode == pgm_read_word(&combo->keys[k])) index = k;
+            }
+            if (index < count) {
+                is_combo_key |= process_single_combo(combo, index, count, keycode, record);
+            }
+        }
+        if (next == COMBO_COUNT) {
+            break;
+        }
+        current_combo_index = next;
         combo_t *combo = &key_combos[current_combo_index];
-        is_combo_key |= process_single_combo(combo, keycode, record);
-    }    
+        is_combo_key |= process_single_combo(combo, combo_index[i].key, combo_length[current_combo_index], keycode, record);
+        unindexed = next + 1;
+        ++i;
+    }
 
     return !is_combo_key;
 }
 
 void matrix_scan_combo(void)
 {
+    if (!combo_timer_running) {
+        return;
+    }
+    combo_timer_running = false;
     for (int i = 0; i < COMBO_COUNT; ++i) {
         // Do not treat the (weak) key_combos too strict.
         #pragma GCC diagnostic push
@@ -149,6 +280,14 @@ void matrix_scan_combo(void)
             unregister_code16(combo->prev_key);
             register_code16(combo->prev_key);
 #endif
+        } else if (combo->timer && combo->timer != COMBO_TIMER_ELAPSED) {
+            combo_timer_running = true;
         }
     }
 }
+
+static const process_range_t process_combo_ranges[] = {
+    PROCESS_RANGE_ALL,
+};
+
+const process_handler_t process_combo_handler = PROCESS_HANDLER(process_combo, NULL, process_combo_ranges);
@@ -21,17 +21,26 @@
 #include "progmem.h"
 #include "quantum.h"
 
-typedef struct
-{
-    const uint16_t *keys;
-    uint16_t keycode;        
+#ifndef COMBO_MAX_LENGTH
 #ifdef EXTRA_EXTRA_LONG_COMBOS
-    uint32_t state;
+#define COMBO_MAX_LENGTH 32
 #elif EXTRA_LONG_COMBOS
-    uint16_t state;
+#define COMBO_MAX_LENGTH 16
 #else
-    uint8_t state;
+#define COMBO_MAX_LENGTH 8
+#endif
 #endif
+
+#if COMBO_MAX_LENGTH > 255
+#error "COMBO_MAX_LENGTH must be at most 255"
+#endif
+
+typedef struct
+{
+    const uint16_t *keys;
+    uint16_t keycode;        
+    /* One bit per combo key that is down */
+    uint8_t state[(COMBO_MAX_LENGTH + 7) / 8];
     uint16_t timer;
 #ifdef COMBO_ALLOW_ACTION_KEYS
     keyrecord_t prev_record;
@@ -51,9 +60,32 @@ typedef struct
 #ifndef COMBO_TERM
 #define COMBO_TERM TAPPING_TERM
 #endif
+#if COMBO_COUNT > 255
+#error "COMBO_COUNT must be at most 255"
+#endif
+/* Number of (keycode, combo) pairs the lookup index can hold, 2 bytes each,
+ * enough for two key combos by default. Set it to the number of keys of all
+ * the combos for longer ones, the combos that don't fit are scanned one by
+ * one */
+#ifndef COMBO_INDEX_SIZE
+#define COMBO_INDEX_SIZE (COMBO_COUNT * 2)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern combo_t key_combos[COMBO_COUNT];
 
 bool process_combo(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_combo_handler;
 void matrix_scan_combo(void);
 void process_combo_event(uint8_t combo_index, bool pressed);
+/* Call after changing key_combos, the index is built on the first key otherwise */
+void combo_index_build(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
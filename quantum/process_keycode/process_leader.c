@@ -31,6 +31,102 @@ uint16_t leader_time = 0;
 uint16_t leader_sequence[5] = {0, 0, 0, 0, 0};
 uint8_t leader_sequence_size = 0;
 
+/* Empty unless the keymap has a table */
+__attribute__ ((weak))
+const leader_sequence_t leader_sequences[] PROGMEM = {{NULL, NULL}};
+
+/* The sequences starting with the keys typed so far are [seq_first, seq_last) */
+static uint16_t seq_first;
+static uint16_t seq_last;
+static uint16_t seq_count = UINT16_MAX;
+
+/* Only valid while the sequence starts with the keys typed so far */
+static uint16_t sequence_key(uint16_t i, uint8_t index) {
+  const uint16_t *keys = (const uint16_t *)pgm_read_ptr(&leader_sequences[i].keys);
+  return pgm_read_word(&keys[index]);
+}
+
+#ifndef NO_DEBUG
+/* Whether sequence a sorts before sequence b, the way a dictionary does */
+static bool sequence_before(uint16_t a, uint16_t b) {
+  for (uint8_t index = 0; index < UINT8_MAX; index++) {
+    uint16_t key_a = sequence_key(a, index);
+    uint16_t key_b = sequence_key(b, index);
+    if (key_a != key_b) {
+      return key_a < key_b;
+    }
+    if (key_a == LEADER_END) {
+      break;
+    }
+  }
+  return false;
+}
+#endif
+
+static uint16_t count_sequences(void) {
+  uint16_t count = 0;
+  while (pgm_read_ptr(&leader_sequences[count].keys)) {
+#ifndef NO_DEBUG
+    // the lookup silently misses sequences of an unsorted table
+    if (count && !sequence_before(count - 1, count)) {
+      xprintf("leader_sequences is not sorted at %u\n", count);
+    }
+#endif
+    count++;
+  }
+  return count;
+}
+
+/* The first sequence in [first, last) whose next key is at least keycode, or
+ * more than keycode with after */
+static uint16_t find_sequence(uint16_t first, uint16_t last, uint16_t keycode, bool after) {
+  while (first < last) {
+    uint16_t mid = first + (last - first) / 2;
+    uint16_t key = sequence_key(mid, leader_sequence_size);
+    if (key < keycode || (after && key == keycode)) {
+      first = mid + 1;
+    } else {
+      last = mid;
+    }
+  }
+  return first;
+}
+
+static void finish_sequence(leader_fn_t fn) {
+  leading = false;
+  leader_end();
+  if (fn) {
+    fn();
+  }
+}
+
+/* Narrows the sequences down by the key, and runs the one that is left as
+ * soon as no other sequence could still match */
+static void match_sequence(uint16_t keycode) {
+  seq_first = find_sequence(seq_first, seq_last, keycode, false);
+  seq_last = find_sequence(seq_first, seq_last, keycode, true);
+  if (leader_sequence_size < UINT8_MAX) {
+    leader_sequence_size++;
+  }
+  if (seq_first == seq_last) {
+    finish_sequence(NULL);
+  } else if (seq_last - seq_first == 1 && sequence_key(seq_first, leader_sequence_size) == LEADER_END) {
+    finish_sequence((leader_fn_t)pgm_read_ptr(&leader_sequences[seq_first].fn));
+  }
+}
+
+void matrix_scan_leader(void) {
+  if (!leading || !seq_count || timer_elapsed(leader_time) <= LEADER_TIMEOUT) {
+    return;
+  }
+  // The shortest of the sequences left is the one that was typed
+  if (leader_sequence_size && sequence_key(seq_first, leader_sequence_size) == LEADER_END) {
+    finish_sequence((leader_fn_t)pgm_read_ptr(&leader_sequences[seq_first].fn));
+  } else {
+    finish_sequence(NULL);
+  }
+}
+
 bool process_leader(uint16_t keycode, keyrecord_t *record) {
   // Leader key set-up
   if (record->event.pressed) {
@@ -44,15 +140,36 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
       leader_sequence[2] = 0;
       leader_sequence[3] = 0;
       leader_sequence[4] = 0;
+      if (seq_count == UINT16_MAX) {
+        seq_count = count_sequences();
+      }
+      seq_first = 0;
+      seq_last = seq_count;
       return false;
     }
     if (leading && timer_elapsed(leader_time) < LEADER_TIMEOUT) {
-      leader_sequence[leader_sequence_size] = keycode;
-      leader_sequence_size++;
+      if (leader_sequence_size < 5) {
+        leader_sequence[leader_sequence_size] = keycode;
+      }
+      if (seq_count) {
+        match_sequence(keycode);
+      } else if (leader_sequence_size < UINT8_MAX) {
+        leader_sequence_size++;
+      }
       return false;
     }
   }
   return true;
 }
 
+static bool leader_active(void) {
+  return leading;
+}
+
+static const process_range_t process_leader_ranges[] = {
+  { KC_LEAD, KC_LEAD },
+};
+
+const process_handler_t process_leader_handler = PROCESS_HANDLER(process_leader, leader_active, process_leader_ranges);
+
 #endif
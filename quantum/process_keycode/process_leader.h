@@ -20,6 +20,7 @@
 #include "quantum.h"
 
 bool process_leader(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_leader_handler;
 
 void leader_start(void);
 void leader_end(void);
@@ -33,6 +34,30 @@ void leader_end(void);
 #define SEQ_FOUR_KEYS(key1, key2, key3, key4) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == 0)
 #define SEQ_FIVE_KEYS(key1, key2, key3, key4, key5) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == (key5))
 
+/* A table of leader sequences, sorted by their keys, that is looked up as the
+ * keys are typed instead of in matrix_scan_user(). The keys of each sequence
+ * are a LEADER_END terminated PROGMEM array, like the combo keys:
+ *
+ *   const uint16_t PROGMEM leader_ws[] = {KC_W, KC_S, LEADER_END};
+ *   const leader_sequence_t PROGMEM leader_sequences[] = LEADER_TABLE(
+ *     LEADER_SEQ(leader_ws, save_file)
+ *   );
+ */
+typedef void (*leader_fn_t)(void);
+
+typedef struct {
+  const uint16_t *keys;
+  leader_fn_t fn;
+} leader_sequence_t;
+
+#define LEADER_END 0
+#define LEADER_TABLE(...) {__VA_ARGS__, {NULL, NULL}}
+#define LEADER_SEQ(keys, fn) {&(keys)[0], (fn)}
+
+extern const leader_sequence_t leader_sequences[];
+
+void matrix_scan_leader(void);
+
 #define LEADER_EXTERNS() extern bool leading; extern uint16_t leader_time; extern uint16_t leader_sequence[5]; extern uint8_t leader_sequence_size
 #define LEADER_DICTIONARY() if (leading && timer_elapsed(leader_time) > LEADER_TIMEOUT)
 
@@ -248,6 +248,12 @@ bool process_midi(uint16_t keycode, keyrecord_t *record)
     return true;
 }
 
+static const process_range_t process_midi_ranges[] = {
+    { MIDI_TONE_MIN, MI_MODSU },
+};
+
+const process_handler_t process_midi_handler = PROCESS_HANDLER(process_midi, NULL, process_midi_ranges);
+
 #endif // MIDI_ADVANCED
 
 #endif // MIDI_ENABLE
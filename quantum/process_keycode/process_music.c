@@ -251,4 +251,10 @@ void music_on_user() {}
 __attribute__ ((weak))
 void music_scale_user() {}
 
+static const process_range_t process_music_ranges[] = {
+    { MU_ON, MU_MOD },
+};
+
+const process_handler_t process_music_handler = PROCESS_HANDLER(process_music, is_music_on, process_music_ranges);
+
 #endif // defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))
\ No newline at end of file
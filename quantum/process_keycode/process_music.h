@@ -30,6 +30,7 @@ enum music_modes {
 };
 
 bool process_music(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_music_handler;
 
 bool is_music_on(void);
 void music_toggle(void);
@@ -268,3 +268,13 @@ bool process_printer(uint16_t keycode, keyrecord_t *record) {
 	return true;
 
 }
+
+static bool printer_active(void) {
+	return printing_enabled;
+}
+
+static const process_range_t process_printer_ranges[] = {
+	{ PRINT_ON, PRINT_OFF },
+};
+
+const process_handler_t process_printer_handler = PROCESS_HANDLER(process_printer, printer_active, process_printer_ranges);
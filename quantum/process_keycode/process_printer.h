@@ -22,5 +22,6 @@
 #include "protocol/serial.h"
 
 bool process_printer(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_printer_handler;
 
 #endif
@@ -18,6 +18,7 @@
 #include "eeprom.h"
 #include "keymap_steno.h"
 #include "virtser.h"
+#include "timer.h"
 
 // TxBolt Codes
 #define TXB_NUL 0
@@ -57,9 +58,29 @@
 #define GEMINI_STATE_SIZE 6
 #define MAX_STATE_SIZE GEMINI_STATE_SIZE
 
-uint8_t state[MAX_STATE_SIZE] = {0};
+/* The keys of a chord, seven to a byte in GeminiPR order, whatever the mode */
+#define CHORD_SIZE GEMINI_STATE_SIZE
+#define CHORD_BYTE(key) ((key) / 7)
+#define CHORD_BIT(key) (1 << (6 - (key) % 7))
+
+typedef struct {
+  uint8_t length;
+  uint8_t data[MAX_STATE_SIZE + 1];
+} steno_packet_t;
+
+static uint8_t chord[CHORD_SIZE];
+static uint8_t held[CHORD_SIZE];
+static uint8_t last_stroke[CHORD_SIZE];
 uint8_t pressed = 0;
+/* Whether the chord has a key that wasn't in a stroke yet */
+static bool chord_pending = false;
+static uint16_t chord_timer;
 steno_mode_t mode;
+static steno_chord_mode_t chord_mode = STENO_CHORD_MODE;
+
+static steno_packet_t queue[STENO_QUEUE_SIZE];
+static uint8_t queue_head;
+static uint8_t queue_count;
 
 uint8_t boltmap[64] = {
   TXB_NUL, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM,
@@ -71,7 +92,8 @@ uint8_t boltmap[64] = {
 };
 
 void steno_clear_state(void) {
-  __builtin_memset(state, 0, sizeof(state));
+  __builtin_memset(chord, 0, sizeof(chord));
+  chord_pending = false;
 }
 
 void steno_init() {
@@ -79,6 +101,7 @@ void steno_init() {
     eeconfig_init();
   }
   mode = eeprom_read_byte(EECONFIG_STENOMODE);
+  __builtin_memset(last_stroke, 0, sizeof(last_stroke));
 }
 
 void steno_set_mode(steno_mode_t new_mode) {
@@ -87,36 +110,133 @@ void steno_set_mode(steno_mode_t new_mode) {
   eeprom_update_byte(EECONFIG_STENOMODE, mode);
 }
 
-void send_steno_state(uint8_t size, bool send_empty) {
-  for (uint8_t i = 0; i < size; ++i) {
-    if (state[i] || send_empty) {
-      virtser_send(state[i]);
+void steno_set_chord_mode(steno_chord_mode_t new_chord_mode) {
+  steno_clear_state();
+  chord_mode = new_chord_mode;
+}
+
+static uint8_t encode_bolt(const uint8_t *keys, uint8_t *packet) {
+  uint8_t state[BOLT_STATE_SIZE] = {0};
+  for (uint8_t key = 0; key <= STN__MAX - STN__MIN; key++) {
+    if (keys[CHORD_BYTE(key)] & CHORD_BIT(key)) {
+      uint8_t boltcode = boltmap[key];
+      state[TXB_GET_GROUP(boltcode)] |= boltcode;
     }
   }
-  steno_clear_state();
+  uint8_t length = 0;
+  for (uint8_t i = 0; i < BOLT_STATE_SIZE; i++) {
+    if (state[i]) {
+      packet[length++] = state[i];
+    }
+  }
+  packet[length++] = 0; // terminating byte
+  return length;
+}
+
+static uint8_t encode_gemini(const uint8_t *keys, uint8_t *packet) {
+  __builtin_memcpy(packet, keys, GEMINI_STATE_SIZE);
+  packet[0] |= 0x80; // Indicate start of packet
+  return GEMINI_STATE_SIZE;
+}
+
+static void send_packet(const steno_packet_t *packet) {
+  virtser_send_buffer(packet->data, packet->length);
+}
+
+/* Sends the oldest queued stroke, returns false when there is none */
+static bool send_queued_stroke(void) {
+  if (!queue_count) {
+    return false;
+  }
+  send_packet(&queue[queue_head]);
+  queue_head = (queue_head + 1) % STENO_QUEUE_SIZE;
+  queue_count--;
+  return true;
+}
+
+static void queue_stroke(const uint8_t *keys) {
+  if (queue_count == STENO_QUEUE_SIZE) {
+    // Strokes are never dropped, the oldest one goes out now instead
+    send_queued_stroke();
+  }
+  steno_packet_t *packet = &queue[(queue_head + queue_count) % STENO_QUEUE_SIZE];
+  switch (mode) {
+    case STENO_MODE_BOLT:
+      packet->length = encode_bolt(keys, packet->data);
+      break;
+    case STENO_MODE_GEMINI:
+      packet->length = encode_gemini(keys, packet->data);
+      break;
+    default:
+      return;
+  }
+  queue_count++;
+}
+
+static void send_stroke(void) {
+  __builtin_memcpy(last_stroke, chord, sizeof(chord));
+  queue_stroke(chord);
+  chord_pending = false;
 }
 
-bool update_state_bolt(uint8_t key) {
-  uint8_t boltcode = boltmap[key];
-  state[TXB_GET_GROUP(boltcode)] |= boltcode;
-  return false;
+void steno_repeat_last_stroke(void) {
+  /* Nothing to repeat before the first stroke, an empty one isn't sent */
+  for (uint8_t i = 0; i < CHORD_SIZE; i++) {
+    if (last_stroke[i]) {
+      queue_stroke(last_stroke);
+      return;
+    }
+  }
 }
 
-bool send_state_bolt(void) {
-  send_steno_state(BOLT_STATE_SIZE, false);
-  virtser_send(0); // terminating byte
-  return false;
+void steno_task(void) {
+  if (chord_mode == STENO_CHORD_FIRST_DOWN && chord_pending &&
+      timer_elapsed(chord_timer) >= STENO_CHORD_TERM) {
+    send_stroke();
+    steno_clear_state();
+  }
+  send_queued_stroke();
 }
 
-bool update_state_gemini(uint8_t key) {
-  state[key / 7] |= 1 << (6 - (key % 7));
-  return false;
+uint8_t steno_queued_strokes(void) {
+  return queue_count;
 }
 
-bool send_state_gemini(void) {
-  state[0] |= 0x80; // Indicate start of packet
-  send_steno_state(GEMINI_STATE_SIZE, true);
-  return false;
+static void steno_press(uint8_t key) {
+  if (!chord_pending) {
+    if (chord_mode == STENO_CHORD_FIRST_DOWN) {
+      steno_clear_state();
+    }
+    chord_timer = timer_read();
+  }
+  chord[CHORD_BYTE(key)] |= CHORD_BIT(key);
+  held[CHORD_BYTE(key)] |= CHORD_BIT(key);
+  chord_pending = true;
+  ++pressed;
+}
+
+static void steno_release(uint8_t key) {
+  held[CHORD_BYTE(key)] &= ~CHORD_BIT(key);
+  if (pressed) {
+    --pressed;
+  }
+  switch (chord_mode) {
+    case STENO_CHORD_FIRST_UP:
+      if (chord_pending) {
+        send_stroke();
+        // The keys still held start the next chord
+        __builtin_memcpy(chord, held, sizeof(chord));
+      }
+      break;
+    default:
+      if (!pressed && chord_pending) {
+        send_stroke();
+      }
+      break;
+  }
+  if (!pressed) {
+    steno_clear_state();
+  }
 }
 
 bool process_steno(uint16_t keycode, keyrecord_t *record) {
@@ -133,33 +253,25 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
       }
       return false;
 
+    case QK_STENO_REPEAT:
+      if (IS_PRESSED(record->event)) {
+        steno_repeat_last_stroke();
+      }
+      return false;
+
     case STN__MIN...STN__MAX:
       if (IS_PRESSED(record->event)) {
-        uint8_t key = keycode - QK_STENO;
-        ++pressed;
-        switch(mode) {
-          case STENO_MODE_BOLT:
-            return update_state_bolt(key);
-          case STENO_MODE_GEMINI:
-            return update_state_gemini(key);
-          default:
-            return false;
-        }
+        steno_press(keycode - QK_STENO);
       } else {
-        --pressed;
-        if (pressed <= 0) {
-          pressed = 0;
-          switch(mode) {
-            case STENO_MODE_BOLT:
-              return send_state_bolt();
-            case STENO_MODE_GEMINI:
-              return send_state_gemini();
-            default:
-              return false;
-          }
-        }
+        steno_release(keycode - QK_STENO);
       }
-
+      return false;
   }
   return true;
 }
+
+static const process_range_t process_steno_ranges[] = {
+  { QK_STENO, QK_STENO_MAX },
+};
+
+const process_handler_t process_steno_handler = PROCESS_HANDLER(process_steno, NULL, process_steno_ranges);
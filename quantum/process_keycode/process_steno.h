@@ -24,8 +24,45 @@
 
 typedef enum { STENO_MODE_BOLT, STENO_MODE_GEMINI } steno_mode_t;
 
+/* When a chord is sent as a stroke */
+typedef enum {
+  /* Once all of its keys are released */
+  STENO_CHORD_ALL_UP,
+  /* Once the first of its keys is released, the keys still held start the next chord */
+  STENO_CHORD_FIRST_UP,
+  /* STENO_CHORD_TERM after its first key is pressed, or once all of its keys are released */
+  STENO_CHORD_FIRST_DOWN
+} steno_chord_mode_t;
+
+#ifndef STENO_CHORD_MODE
+  #define STENO_CHORD_MODE STENO_CHORD_ALL_UP
+#endif
+
+#ifndef STENO_CHORD_TERM
+  #define STENO_CHORD_TERM 50
+#endif
+
+/* Strokes waiting for steno_task(), more are sent right away */
+#ifndef STENO_QUEUE_SIZE
+  #define STENO_QUEUE_SIZE 4
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 bool process_steno(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_steno_handler;
 void steno_init(void);
 void steno_set_mode(steno_mode_t mode);
+void steno_set_chord_mode(steno_chord_mode_t chord_mode);
+void steno_repeat_last_stroke(void);
+/* Sends a queued stroke, a single virtual serial write each */
+void steno_task(void);
+uint8_t steno_queued_strokes(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
\ No newline at end of file
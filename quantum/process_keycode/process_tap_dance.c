@@ -19,7 +19,58 @@
 uint8_t get_oneshot_mods(void);
 
 static uint16_t last_td;
-static int8_t highest_td = -1;
+static int16_t highest_td = -1;
+
+/* The dances with a count, so that the others are never looked at */
+static uint8_t active_td[(QK_TAP_DANCE_MAX - QK_TAP_DANCE + 1) / 8];
+static uint8_t active_td_count;
+
+/* The earliest a dance can time out, matrix_scan_tap_dance() does nothing
+ * before then */
+static bool deadline_set;
+static uint16_t deadline_timer;
+static uint16_t deadline_term;
+
+static inline bool is_active_td(uint8_t idx) {
+  return active_td[idx / 8] & (1 << (idx % 8));
+}
+
+static void set_active_td(uint8_t idx, bool active) {
+  if (is_active_td(idx) == active)
+    return;
+  if (active) {
+    active_td[idx / 8] |= 1 << (idx % 8);
+    active_td_count++;
+  } else {
+    active_td[idx / 8] &= ~(1 << (idx % 8));
+    active_td_count--;
+  }
+}
+
+static inline uint16_t get_tap_dance_term(qk_tap_dance_action_t *action) {
+  return action->custom_tapping_term > 0 ? action->custom_tapping_term : TAPPING_TERM;
+}
+
+/* Moves the deadline earlier, to when timer_elapsed(timer) > term */
+static void schedule_deadline(uint16_t timer, uint16_t term) {
+  if (deadline_set &&
+      (int32_t)term - timer_elapsed(timer) >= (int32_t)deadline_term - timer_elapsed(deadline_timer))
+    return;
+  deadline_set = true;
+  deadline_timer = timer;
+  deadline_term = term;
+}
+
+/* Returns the next active dance after idx, or -1 */
+static int16_t next_active_td(int16_t idx) {
+  for (idx++; idx <= highest_td; idx++) {
+    if (!active_td[idx / 8])
+      idx |= 7;
+    else if (is_active_td(idx))
+      return idx;
+  }
+  return -1;
+}
 
 void qk_tap_dance_pair_finished (qk_tap_dance_state_t *state, void *user_data) {
   qk_tap_dance_pair_t *pair = (qk_tap_dance_pair_t *)user_data;
@@ -109,6 +160,8 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
       action->state.keycode = keycode;
       action->state.count++;
       action->state.timer = timer_read();
+      set_active_td(idx, true);
+      schedule_deadline(action->state.timer, get_tap_dance_term(action));
       action->state.oneshot_mods = get_oneshot_mods();
       process_tap_dance_action_on_each_tap (action);
 
@@ -120,6 +173,9 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
       }
 
       last_td = keycode;
+    } else if (action->state.count && action->state.finished) {
+      /* Was held past the end of the dance, reset once it times out */
+      schedule_deadline(action->state.timer, get_tap_dance_term(action));
     }
 
     break;
@@ -128,13 +184,11 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
     if (!record->event.pressed)
       return true;
 
-    if (highest_td == -1)
+    if (!active_td_count)
       return true;
 
-    for (int i = 0; i <= highest_td; i++) {
+    for (int16_t i = next_active_td(-1); i >= 0; i = next_active_td(i)) {
       action = &tap_dance_actions[i];
-      if (action->state.count == 0)
-        continue;
       action->state.interrupted = true;
       process_tap_dance_action_on_dance_finished (action);
       reset_tap_dance (&action->state);
@@ -148,21 +202,18 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
 
 void matrix_scan_tap_dance () {
-  if (highest_td == -1)
+  if (!deadline_set || timer_elapsed(deadline_timer) <= deadline_term)
     return;
-  uint16_t tap_user_defined;
 
-for (uint8_t i = 0; i <= highest_td; i++) {
+  deadline_set = false;
+  for (int16_t i = next_active_td(-1); i >= 0; i = next_active_td(i)) {
     qk_tap_dance_action_t *action = &tap_dance_actions[i];
-    if(action->custom_tapping_term > 0 ) {
-      tap_user_defined = action->custom_tapping_term;
-    }
-    else{
-      tap_user_defined = TAPPING_TERM;
-    }
-    if (action->state.count && timer_elapsed (action->state.timer) > tap_user_defined) {
+    uint16_t term = get_tap_dance_term(action);
+    if (timer_elapsed (action->state.timer) > term) {
       process_tap_dance_action_on_dance_finished (action);
       reset_tap_dance (&action->state);
+    } else {
+      schedule_deadline(action->state.timer, term);
     }
   }
 }
@@ -181,4 +232,15 @@ void reset_tap_dance (qk_tap_dance_state_t *state) {
   state->interrupted = false;
   state->finished = false;
   last_td = 0;
+  set_active_td(state->keycode - QK_TAP_DANCE, false);
+}
+
+static bool tap_dance_active(void) {
+  return last_td || active_td_count;
 }
+
+static const process_range_t process_tap_dance_ranges[] = {
+  { QK_TAP_DANCE, QK_TAP_DANCE_MAX },
+};
+
+const process_handler_t process_tap_dance_handler = PROCESS_HANDLER(process_tap_dance, tap_dance_active, process_tap_dance_ranges);
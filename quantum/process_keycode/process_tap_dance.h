@@ -86,11 +86,16 @@ typedef struct
     .custom_tapping_term = tap_specific_tapping_term, \
   }
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 extern qk_tap_dance_action_t tap_dance_actions[];
 
 /* To be used internally */
 
 bool process_tap_dance(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_tap_dance_handler;
 void matrix_scan_tap_dance (void);
 void reset_tap_dance (qk_tap_dance_state_t *state);
 
@@ -100,6 +105,10 @@ void qk_tap_dance_pair_reset (qk_tap_dance_state_t *state, void *user_data);
 void qk_tap_dance_dual_role_finished (qk_tap_dance_state_t *state, void *user_data);
 void qk_tap_dance_dual_role_reset (qk_tap_dance_state_t *state, void *user_data);
 
+#ifdef __cplusplus
+}
+#endif
+
 #else
 
 #define TD(n) KC_NO
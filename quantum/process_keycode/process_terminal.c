@@ -249,4 +249,14 @@ bool process_terminal(uint16_t keycode, keyrecord_t *record) {
         }
     }
     return true;
-}
\ No newline at end of file
+}
+
+static bool terminal_active(void) {
+    return terminal_enabled;
+}
+
+static const process_range_t process_terminal_ranges[] = {
+    { TERM_ON, TERM_OFF },
+};
+
+const process_handler_t process_terminal_handler = PROCESS_HANDLER(process_terminal, terminal_active, process_terminal_ranges);
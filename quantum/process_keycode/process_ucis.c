@@ -102,7 +102,10 @@ bool process_ucis (uint16_t keycode, keyrecord_t *record) {
   if (!record->event.pressed)
     return true;
 
-  qk_ucis_state.codes[qk_ucis_state.count] = keycode;
+  // A full sequence only accepts the keys above, which aren't stored
+  if (qk_ucis_state.count < UCIS_MAX_SYMBOL_LENGTH) {
+    qk_ucis_state.codes[qk_ucis_state.count] = keycode;
+  }
   qk_ucis_state.count++;
 
   if (keycode == KC_BSPC) {
@@ -147,3 +150,9 @@ bool process_ucis (uint16_t keycode, keyrecord_t *record) {
   }
   return true;
 }
+
+static bool ucis_active(void) {
+  return qk_ucis_state.in_progress;
+}
+
+const process_handler_t process_ucis_handler = { process_ucis, ucis_active, NULL, 0 };
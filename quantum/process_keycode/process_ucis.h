@@ -47,5 +47,6 @@ void qk_ucis_start_user(void);
 void qk_ucis_symbol_fallback (void);
 void register_ucis(const char *hex);
 bool process_ucis (uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_ucis_handler;
 
 #endif
@@ -33,3 +33,8 @@ bool process_unicode(uint16_t keycode, keyrecord_t *record) {
   return true;
 }
 
+static const process_range_t process_unicode_ranges[] = {
+  { QK_UNICODE + 1, QK_UNICODE_MAX },
+};
+
+const process_handler_t process_unicode_handler = PROCESS_HANDLER(process_unicode, NULL, process_unicode_ranges);
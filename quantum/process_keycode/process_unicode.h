@@ -20,5 +20,6 @@
 #include "process_unicode_common.h"
 
 bool process_unicode(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_unicode_handler;
 
 #endif
@@ -35,15 +35,11 @@ void unicode_input_start (void) {
   // save current mods
   mods = keyboard_report->mods;
 
-  // unregister all mods to start from clean state
-  if (mods & MOD_BIT(KC_LSFT)) unregister_code(KC_LSFT);
-  if (mods & MOD_BIT(KC_RSFT)) unregister_code(KC_RSFT);
-  if (mods & MOD_BIT(KC_LCTL)) unregister_code(KC_LCTL);
-  if (mods & MOD_BIT(KC_RCTL)) unregister_code(KC_RCTL);
-  if (mods & MOD_BIT(KC_LALT)) unregister_code(KC_LALT);
-  if (mods & MOD_BIT(KC_RALT)) unregister_code(KC_RALT);
-  if (mods & MOD_BIT(KC_LGUI)) unregister_code(KC_LGUI);
-  if (mods & MOD_BIT(KC_RGUI)) unregister_code(KC_RGUI);
+  // unregister all mods to start from clean state, in a single report
+  if (mods) {
+    clear_mods();
+    send_keyboard_report();
+  }
 
   switch(input_mode) {
   case UC_OSX:
@@ -91,14 +87,10 @@ void unicode_input_finish (void) {
   }
 
   // reregister previously set mods
-  if (mods & MOD_BIT(KC_LSFT)) register_code(KC_LSFT);
-  if (mods & MOD_BIT(KC_RSFT)) register_code(KC_RSFT);
-  if (mods & MOD_BIT(KC_LCTL)) register_code(KC_LCTL);
-  if (mods & MOD_BIT(KC_RCTL)) register_code(KC_RCTL);
-  if (mods & MOD_BIT(KC_LALT)) register_code(KC_LALT);
-  if (mods & MOD_BIT(KC_RALT)) register_code(KC_RALT);
-  if (mods & MOD_BIT(KC_LGUI)) register_code(KC_LGUI);
-  if (mods & MOD_BIT(KC_RGUI)) register_code(KC_RGUI);
+  if (mods) {
+    add_mods(mods);
+    send_keyboard_report();
+  }
 }
 
 __attribute__((weak))
@@ -120,3 +112,238 @@ void register_hex(uint16_t hex) {
     unregister_code(hex_to_keycode(digit));
   }
 }
+
+/* Unicode strings
+ *
+ * Types UTF-8 strings with as few reports as each input mode allows. The
+ * mods are left out of the reports until the whole string has been typed,
+ * the mode keys are pressed together, and each hex digit is pressed in the
+ * same report that releases the one before it.
+ */
+static const char *output_str;
+static bool output_progmem;
+static bool output_waiting;
+static uint16_t output_timer;
+static uint32_t output_code_point;
+static uint8_t output_held_key;
+
+static uint8_t output_read_byte(const char *p) {
+  return output_progmem ? pgm_read_byte(p) : *p;
+}
+
+/* decodes the next code point, or returns 0 at the end of the string */
+static uint32_t output_next_code_point(void) {
+  uint8_t c = output_read_byte(output_str);
+  if (!c) {
+    return 0;
+  }
+  output_str++;
+  uint8_t continuation;
+  uint32_t code_point;
+  if (c < 0x80) {
+    return c;
+  } else if ((c & 0xE0) == 0xC0) {
+    code_point = c & 0x1F;
+    continuation = 1;
+  } else if ((c & 0xF0) == 0xE0) {
+    code_point = c & 0x0F;
+    continuation = 2;
+  } else if ((c & 0xF8) == 0xF0) {
+    code_point = c & 0x07;
+    continuation = 3;
+  } else {
+    return 0xFFFD;
+  }
+  for (; continuation; continuation--) {
+    c = output_read_byte(output_str);
+    if ((c & 0xC0) != 0x80) {
+      return 0xFFFD;
+    }
+    code_point = code_point << 6 | (c & 0x3F);
+    output_str++;
+  }
+  return code_point;
+}
+
+/* presses the key, and releases the one before it in the same report */
+static void output_roll_key(uint8_t key) {
+  if (output_held_key) {
+    del_key(output_held_key);
+    if (output_held_key == key) {
+      send_keyboard_report();
+    }
+  }
+  add_key(key);
+  send_keyboard_report();
+  output_held_key = key;
+}
+
+static void output_release(uint8_t macro_mods) {
+  del_macro_mods(macro_mods);
+  if (output_held_key) {
+    del_key(output_held_key);
+    output_held_key = 0;
+  }
+  send_keyboard_report();
+}
+
+static void output_roll_hex(uint32_t hex) {
+  // at least four digits, like register_hex()
+  int8_t i = 7;
+  while (i > 3 && !((hex >> (i * 4)) & 0xF)) {
+    i--;
+  }
+  for (; i >= 0; i--) {
+    output_roll_key(hex_to_keycode((hex >> (i * 4)) & 0xF));
+  }
+}
+
+static void output_input_start(void) {
+  switch (input_mode) {
+  case UC_OSX:
+    add_macro_mods(MOD_BIT(KC_LALT));
+    send_keyboard_report();
+    break;
+  case UC_OSX_RALT:
+    add_macro_mods(MOD_BIT(KC_RALT));
+    send_keyboard_report();
+    break;
+  case UC_LNX:
+    add_macro_mods(MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT));
+    output_roll_key(KC_U);
+    output_release(MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT));
+    break;
+  case UC_WIN:
+    add_macro_mods(MOD_BIT(KC_LALT));
+    output_roll_key(KC_PPLS);
+    break;
+  case UC_WINC:
+    add_macro_mods(MOD_BIT(KC_RALT));
+    send_keyboard_report();
+    del_macro_mods(MOD_BIT(KC_RALT));
+    output_roll_key(KC_U);
+    break;
+  }
+}
+
+static void output_input_finish(void) {
+  switch (input_mode) {
+  case UC_OSX:
+  case UC_WIN:
+    output_release(MOD_BIT(KC_LALT));
+    break;
+  case UC_OSX_RALT:
+    output_release(MOD_BIT(KC_RALT));
+    break;
+  case UC_LNX:
+    output_roll_key(KC_SPC);
+    output_release(0);
+    break;
+  default:
+    output_release(0);
+    break;
+  }
+}
+
+static void output_hex(uint32_t code_point) {
+  if (code_point > 0xFFFF && (input_mode == UC_OSX || input_mode == UC_OSX_RALT)) {
+    // as a UTF-16 surrogate pair
+    code_point -= 0x10000;
+    output_roll_hex(0xD800 + (code_point >> 10));
+    output_roll_hex(0xDC00 + (code_point & 0x3FF));
+  } else {
+    output_roll_hex(code_point);
+  }
+}
+
+/* the code points the input mode can't type are typed as the replacement
+ * character, Alt and the numpad only take four hex digits */
+static uint32_t output_typeable(uint32_t code_point) {
+  uint32_t max = input_mode == UC_WIN ? 0xFFFF : 0x10FFFF;
+  return code_point <= max ? code_point : 0xFFFD;
+}
+
+/* Types the next part of the string, the start of a code point or the rest
+ * of it. Blocking waits for UNICODE_TYPE_DELAY, otherwise it is left to the
+ * next call, and the keyboard holds the key events until the code point is
+ * finished. The real mods are only kept out of the reports sent here, so
+ * that a mod released in the meantime doesn't get stuck.
+ */
+static void output_step(bool blocking) {
+  if (output_waiting && timer_elapsed(output_timer) < UNICODE_TYPE_DELAY) {
+    return;
+  }
+  uint8_t real_mods = get_mods();
+  clear_mods();
+  if (!output_waiting) {
+    output_input_start();
+    output_waiting = true;
+    output_timer = timer_read();
+    if (!blocking) {
+      set_mods(real_mods);
+      return;
+    }
+    wait_ms(UNICODE_TYPE_DELAY);
+  }
+  output_hex(output_code_point);
+  output_input_finish();
+  output_waiting = false;
+  output_code_point = output_typeable(output_next_code_point());
+  set_mods(real_mods);
+  if (!output_code_point) {
+    output_str = NULL;
+    send_keyboard_report();
+  }
+}
+
+static bool output_begin(const char *str, bool progmem) {
+  if (output_str) {
+    return false;
+  }
+  output_str = str;
+  output_progmem = progmem;
+  output_waiting = false;
+  output_code_point = output_typeable(output_next_code_point());
+  if (!output_code_point) {
+    output_str = NULL;
+  }
+  return true;
+}
+
+void send_unicode_string(const char *str) {
+  if (output_begin(str, false)) {
+    while (output_str) {
+      output_step(true);
+    }
+  }
+}
+
+void send_unicode_string_P(const char *str) {
+  if (output_begin(str, true)) {
+    while (output_str) {
+      output_step(true);
+    }
+  }
+}
+
+bool send_unicode_string_async(const char *str) {
+  return output_begin(str, false);
+}
+
+bool send_unicode_string_async_P(const char *str) {
+  return output_begin(str, true);
+}
+
+bool unicode_output_busy(void) {
+  return output_str != NULL;
+}
+
+bool unicode_output_holds_keys(void) {
+  return output_str && output_waiting;
+}
+
+void unicode_output_task(void) {
+  if (output_str) {
+    output_step(false);
+  }
+}
@@ -26,11 +26,33 @@
 __attribute__ ((unused))
 static uint8_t input_mode;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void set_unicode_input_mode(uint8_t os_target);
 uint8_t get_unicode_input_mode(void);
 void unicode_input_start(void);
 void unicode_input_finish(void);
 void register_hex(uint16_t hex);
+uint16_t hex_to_keycode(uint8_t hex);
+
+/* Type a UTF-8 string, blocking until it is done */
+void send_unicode_string(const char *str);
+void send_unicode_string_P(const char *str);
+/* Type a UTF-8 string a code point at a time from the scan loop. Returns
+ * false when another string is still being typed. The string isn't copied. */
+bool send_unicode_string_async(const char *str);
+bool send_unicode_string_async_P(const char *str);
+bool unicode_output_busy(void);
+/* Whether a code point has been started and not finished yet. Keys typed
+ * until then would end up in the input method. */
+bool unicode_output_holds_keys(void);
+void unicode_output_task(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #define UC_OSX 0  // Mac OS X
 #define UC_LNX 1  // Linux
@@ -70,3 +70,9 @@ bool process_unicode_map(uint16_t keycode, keyrecord_t *record) {
   }
   return true;
 }
+
+static const process_range_t process_unicode_map_ranges[] = {
+  { QK_UNICODE_MAP, 0xFFFF },
+};
+
+const process_handler_t process_unicode_map_handler = PROCESS_HANDLER(process_unicode_map, NULL, process_unicode_map_ranges);
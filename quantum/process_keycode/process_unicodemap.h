@@ -22,4 +22,5 @@
 
 void unicode_map_input_error(void);
 bool process_unicode_map(uint16_t keycode, keyrecord_t *record);
+extern const process_handler_t process_unicode_map_handler;
 #endif
@@ -130,6 +130,10 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
   return true;
 }
 
+/* Defined by dynamic_macro.h */
+__attribute__ ((weak))
+void dynamic_macro_task(void) {}
+
 void reset_keyboard(void) {
   clear_keyboard();
 #if defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_ENABLE_BASIC))
@@ -202,48 +206,7 @@ bool process_record_quantum(keyrecord_t *record) {
     process_key_lock(&keycode, record) &&
   #endif
     process_record_kb(keycode, record) &&
-  #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-    process_midi(keycode, record) &&
-  #endif
-  #ifdef AUDIO_ENABLE
-    process_audio(keycode, record) &&
-  #endif
-  #ifdef STENO_ENABLE
-    process_steno(keycode, record) &&
-  #endif
-  #if defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))
-    process_music(keycode, record) &&
-  #endif
-  #ifdef TAP_DANCE_ENABLE
-    process_tap_dance(keycode, record) &&
-  #endif
-  #ifndef DISABLE_LEADER
-    process_leader(keycode, record) &&
-  #endif
-  #ifndef DISABLE_CHORDING
-    process_chording(keycode, record) &&
-  #endif
-  #ifdef COMBO_ENABLE
-    process_combo(keycode, record) &&
-  #endif
-  #ifdef UNICODE_ENABLE
-    process_unicode(keycode, record) &&
-  #endif
-  #ifdef UCIS_ENABLE
-    process_ucis(keycode, record) &&
-  #endif
-  #ifdef PRINTING_ENABLE
-    process_printer(keycode, record) &&
-  #endif
-  #ifdef AUTO_SHIFT_ENABLE
-    process_auto_shift(keycode, record) &&
-  #endif
-  #ifdef UNICODEMAP_ENABLE
-    process_unicode_map(keycode, record) &&
-  #endif
-  #ifdef TERMINAL_ENABLE
-    process_terminal(keycode, record) &&
-  #endif
+    process_dispatch(keycode, record) &&
       true)) {
     return false;
   }
@@ -495,6 +458,7 @@ bool process_record_quantum(keyrecord_t *record) {
             break;
         }
         eeconfig_update_keymap(keymap_config.raw);
+        layer_action_cache_clear(); // the key remapping is part of the cached actions
         clear_keyboard(); // clear to prevent stuck keys
 
         return false;
@@ -765,6 +729,24 @@ void matrix_scan_quantum() {
     matrix_scan_combo();
   #endif
 
+  #ifdef AUTO_SHIFT_ENABLE
+    matrix_scan_auto_shift();
+  #endif
+
+  #ifdef STENO_ENABLE
+    steno_task();
+  #endif
+
+  #ifdef UNICODE_COMMON_ENABLE
+    unicode_output_task();
+  #endif
+
+  #ifndef DISABLE_LEADER
+    matrix_scan_leader();
+  #endif
+
+  dynamic_macro_task();
+
   #if defined(BACKLIGHT_ENABLE) && defined(BACKLIGHT_PIN)
     backlight_task();
   #endif
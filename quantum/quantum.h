@@ -41,6 +41,7 @@
 #include <stdlib.h>
 #include "print.h"
 #include "send_string_keycodes.h"
+#include "process_dispatch.h"
 
 extern uint32_t default_layer_state;
 
@@ -107,6 +108,10 @@ extern uint32_t default_layer_state;
 	#include "process_key_lock.h"
 #endif
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+	#include "send_string_async.h"
+#endif
+
 #ifdef TERMINAL_ENABLE
 	#include "process_terminal.h"
 #else
@@ -152,6 +157,7 @@ void matrix_scan_user(void);
 bool process_action_kb(keyrecord_t *record);
 bool process_record_kb(uint16_t keycode, keyrecord_t *record);
 bool process_record_user(uint16_t keycode, keyrecord_t *record);
+void dynamic_macro_task(void);
 
 void reset_keyboard(void);
 
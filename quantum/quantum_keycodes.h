@@ -75,6 +75,7 @@ enum quantum_keycodes {
     QK_STENO              = 0x5A00,
     QK_STENO_BOLT         = 0x5A30,
     QK_STENO_GEMINI       = 0x5A31,
+    QK_STENO_REPEAT       = 0x5A32,
     QK_STENO_MAX          = 0x5A3F,
 #endif
     QK_MOD_TAP            = 0x6000,
@@ -0,0 +1,140 @@
+/*
+Copyright 2017 QMK Firmware contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "quantum.h"
+#include "send_string_async.h"
+
+typedef struct {
+    const char *str;
+    send_string_async_callback_t callback;
+    uint8_t interval;
+    bool progmem;
+} send_string_async_t;
+
+static send_string_async_t queue[SEND_STRING_ASYNC_QUEUE_SIZE];
+static uint8_t queue_head = 0;
+static uint8_t queue_count = 0;
+static uint16_t last_char_time;
+
+static uint8_t read_char(const send_string_async_t *s, const char *p)
+{
+    return s->progmem ? pgm_read_byte(p) : *p;
+}
+
+static bool enqueue(const char *str, uint8_t interval, send_string_async_callback_t callback, bool progmem)
+{
+    if (queue_count == SEND_STRING_ASYNC_QUEUE_SIZE) {
+        return false;
+    }
+    if (!queue_count) {
+        // the first character doesn't wait for the interval
+        last_char_time = timer_read() - interval;
+    }
+    queue[(queue_head + queue_count) % SEND_STRING_ASYNC_QUEUE_SIZE] = (send_string_async_t){
+        .str = str,
+        .callback = callback,
+        .interval = interval,
+        .progmem = progmem,
+    };
+    queue_count++;
+    return true;
+}
+
+bool send_string_async(const char *str, uint8_t interval, send_string_async_callback_t callback)
+{
+    return enqueue(str, interval, callback, false);
+}
+
+bool send_string_async_P(const char *str, uint8_t interval, send_string_async_callback_t callback)
+{
+    return enqueue(str, interval, callback, true);
+}
+
+bool send_string_async_busy(void)
+{
+    return queue_count > 0;
+}
+
+static void dequeue(bool completed)
+{
+    send_string_async_callback_t callback = queue[queue_head].callback;
+    queue_head = (queue_head + 1) % SEND_STRING_ASYNC_QUEUE_SIZE;
+    queue_count--;
+    if (callback) {
+        callback(completed);
+    }
+}
+
+void send_string_async_cancel(void)
+{
+    if (!queue_count) {
+        return;
+    }
+    // release what SS_DOWN pressed, by doing only the SS_UPs that are left
+    send_string_async_t *s = &queue[queue_head];
+    for (uint8_t c; (c = read_char(s, s->str)); s->str++) {
+        if (c == 3) {
+            unregister_code(read_char(s, ++s->str));
+        } else if (c == 1 || c == 2) {
+            s->str++;
+        }
+    }
+    // only the strings queued so far, a callback may queue new ones
+    for (uint8_t count = queue_count; count; count--) {
+        dequeue(false);
+    }
+}
+
+/* Sends the next character, or SS_ code, like send_string_with_delay() */
+static void send_next(send_string_async_t *s)
+{
+    uint8_t c = read_char(s, s->str);
+    if (c == 1) {
+        uint8_t keycode = read_char(s, ++s->str);
+        register_code(keycode);
+        unregister_code(keycode);
+    } else if (c == 2) {
+        register_code(read_char(s, ++s->str));
+    } else if (c == 3) {
+        unregister_code(read_char(s, ++s->str));
+    } else {
+        send_char(c);
+    }
+    s->str++;
+}
+
+void send_string_async_task(void)
+{
+    uint8_t sent = 0;
+    while (queue_count && sent < SEND_STRING_ASYNC_CHARS_PER_SCAN) {
+        send_string_async_t *s = &queue[queue_head];
+        if (!read_char(s, s->str)) {
+            dequeue(true);
+            continue;
+        }
+        if (s->interval) {
+            if (timer_elapsed(last_char_time) < s->interval) {
+                return;
+            }
+            // one character per interval
+            sent = SEND_STRING_ASYNC_CHARS_PER_SCAN;
+        } else {
+            sent++;
+        }
+        send_next(s);
+        last_char_time = timer_read();
+    }
+}
@@ -0,0 +1,63 @@
+/*
+Copyright 2017 QMK Firmware contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SEND_STRING_ASYNC_H
+#define SEND_STRING_ASYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Sends strings in the background, a character at a time from
+ * keyboard_task(), instead of blocking the keyboard like send_string().
+ * The strings are not copied, so they have to stay around until they
+ * have been sent.
+ */
+
+/* how many strings can wait to be sent */
+#ifndef SEND_STRING_ASYNC_QUEUE_SIZE
+#define SEND_STRING_ASYNC_QUEUE_SIZE 4
+#endif
+
+/* characters sent in each scan, when there is no interval */
+#ifndef SEND_STRING_ASYNC_CHARS_PER_SCAN
+#define SEND_STRING_ASYNC_CHARS_PER_SCAN 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* completed is false when the string was cancelled */
+typedef void (*send_string_async_callback_t)(bool completed);
+
+#define SEND_STRING_ASYNC(str) send_string_async_P(PSTR(str), 0, NULL)
+
+/* Return false when the queue is full. The interval is in ms between
+ * characters, and the callback can be NULL. */
+bool send_string_async(const char *str, uint8_t interval, send_string_async_callback_t callback);
+bool send_string_async_P(const char *str, uint8_t interval, send_string_async_callback_t callback);
+bool send_string_async_busy(void);
+/* Drops all the queued strings, and releases the keys that the current one
+ * is holding down. Strings that their callbacks queue are kept */
+void send_string_async_cancel(void);
+void send_string_async_task(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
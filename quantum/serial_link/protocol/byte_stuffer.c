@@ -35,32 +35,23 @@ typedef struct byte_stuffer_state {
     uint16_t next_zero;
     uint16_t data_pos;
     bool long_frame;
-    uint8_t data[MAX_FRAME_SIZE];
 }byte_stuffer_state_t;
 
-static byte_stuffer_state_t states[NUM_LINKS];
-
 void init_byte_stuffer_state(byte_stuffer_state_t* state) {
     state->next_zero = 0;
     state->data_pos = 0;
     state->long_frame = false;
 }
 
-void init_byte_stuffer(void) {
-    int i;
-    for (i=0;i<NUM_LINKS;i++) {
-        init_byte_stuffer_state(&states[i]);
-    }
-}
-
-void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
-    byte_stuffer_state_t* state = &states[link];
+// Decodes into out, which can be the same buffer as the encoded input, since
+// the output never overtakes the input. Returns true at the end of a frame.
+static bool recv_byte(byte_stuffer_state_t* state, uint8_t link, uint8_t* out, uint8_t data) {
     // Start of a new frame
     if (state->next_zero == 0) {
         state->next_zero = data;
         state->long_frame = data == 0xFF;
         state->data_pos = 0;
-        return;
+        return false;
     }
 
     state->next_zero--;
@@ -68,13 +59,14 @@ void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
         if (state->next_zero == 0) {
             // The frame is completed
             if (state->data_pos > 0) {
-                validator_recv_frame(link, state->data, state->data_pos);
+                validator_recv_frame(link, out, state->data_pos);
             }
         }
         else {
             // The frame is invalid, so reset
             init_byte_stuffer_state(state);
         }
+        return true;
     }
     else {
         if (state->data_pos == MAX_FRAME_SIZE) {
@@ -93,50 +85,84 @@ void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
             else {
                 // Special case for zeroes
                 state->next_zero = data;
-                state->data[state->data_pos++] = 0;
+                out[state->data_pos++] = 0;
             }
         }
         else {
-            state->data[state->data_pos++] = data;
+            out[state->data_pos++] = data;
         }
+        return false;
+    }
+}
+
+#ifdef BYTE_STUFFER_RECV_BYTE
+typedef struct byte_stuffer_link {
+    byte_stuffer_state_t state;
+    // Room to encode the frame in place again, if it's forwarded
+    uint8_t header[BYTE_STUFFER_HEADER];
+    uint8_t data[MAX_FRAME_SIZE + 1];
+}byte_stuffer_link_t;
+
+static byte_stuffer_link_t links[NUM_LINKS];
+
+void init_byte_stuffer(void) {
+    int i;
+    for (i=0;i<NUM_LINKS;i++) {
+        init_byte_stuffer_state(&links[i].state);
     }
 }
 
-static void send_block(uint8_t link, uint8_t* start, uint8_t* end, uint8_t num_non_zero) {
-    send_data(link, &num_non_zero, 1);
-    if (end > start) {
-        send_data(link, start, end-start);
+void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
+    byte_stuffer_link_t* l = &links[link];
+    recv_byte(&l->state, link, l->data, data);
+}
+#endif
+
+uint16_t byte_stuffer_recv_frame(uint8_t link, uint8_t* data, uint16_t size) {
+    byte_stuffer_state_t state;
+    init_byte_stuffer_state(&state);
+    uint16_t i;
+    for (i = 0; i < size; i++) {
+        if (recv_byte(&state, link, data, data[i])) {
+            return i + 1;
+        }
     }
+    return 0;
 }
 
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
-    const uint8_t zero = 0;
     if (size > 0) {
-        uint16_t num_non_zero = 1;
-        uint8_t* end = data + size;
-        uint8_t* start = data;
+        // The encoded frame starts in the header, and can never overtake
+        // the data it's reading, since it's at most one code per block longer
+        uint8_t* out = data - BYTE_STUFFER_HEADER;
+        uint8_t* const start = out;
+        uint8_t* code = out++;
+        uint8_t num_non_zero = 1;
+        const uint8_t* end = data + size;
         while (data < end) {
             if (num_non_zero == 0xFF) {
                 // There's more data after big non-zero block
-                // So send it, and start a new block
-                send_block(link, start, data, num_non_zero);
-                start = data;
+                // So start a new block
+                *code = num_non_zero;
+                code = out++;
                 num_non_zero = 1;
             }
             else {
                 if (*data == 0) {
-                    // A zero encountered, so send the block
-                    send_block(link, start, data, num_non_zero);
-                    start = data + 1;
+                    // A zero encountered, so end the block
+                    *code = num_non_zero;
+                    code = out++;
                     num_non_zero = 1;
                 }
                 else {
+                    *out++ = *data;
                     num_non_zero++;
                 }
                 ++data;
             }
         }
-        send_block(link, start, data, num_non_zero);
-        send_data(link, &zero, 1);
+        *code = num_non_zero;
+        *out++ = 0;
+        send_data(link, start, out - start);
     }
 }
@@ -29,9 +29,23 @@ SOFTWARE.
 
 #define MAX_FRAME_SIZE 1024
 #define NUM_LINKS 2
+// The frames are encoded in place, and grow by this much at most in front,
+// and by the terminating zero at the end
+#define BYTE_STUFFER_HEADER (1 + MAX_FRAME_SIZE / 254)
 
+#ifdef BYTE_STUFFER_RECV_BYTE
+// Decodes a byte at a time into a frame buffer per link, only the tests use
+// this, the firmware receives whole frames with frame_receiver
 void init_byte_stuffer(void);
 void byte_stuffer_recv_byte(uint8_t link, uint8_t data);
+#endif
+// Decodes the first frame of the buffer in place, and returns the number of
+// bytes used, including the terminating zero, or 0 if the frame is not
+// complete yet. The buffer needs BYTE_STUFFER_HEADER free bytes in front of
+// it, in case the frame is forwarded.
+uint16_t byte_stuffer_recv_frame(uint8_t link, uint8_t* data, uint16_t size);
+// The buffer needs BYTE_STUFFER_HEADER free bytes in front of it and one
+// after it, and is overwritten by the encoded frame
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size);
 
 #endif
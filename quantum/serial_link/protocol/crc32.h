@@ -0,0 +1,69 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 Fred Sundvik
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SERIAL_LINK_CRC32_H
+#define SERIAL_LINK_CRC32_H
+
+#include <stdint.h>
+
+/*
+ * The CRC-32 of the frames, as in Ethernet and zlib. Pick the backend with
+ * SERIAL_LINK_CRC in config.h:
+ * SERIAL_LINK_CRC_TABLE          a byte at a time, from a 1 KB table (default)
+ * SERIAL_LINK_CRC_SLICING_BY_4   four bytes at a time, from 4 KB of tables
+ * SERIAL_LINK_CRC_SLICING_BY_8   eight bytes at a time, from 8 KB of tables
+ * SERIAL_LINK_CRC_HARDWARE       the keyboard's CRC peripheral, through
+ *                                crc32_hardware()
+ */
+#define SERIAL_LINK_CRC_TABLE 0
+#define SERIAL_LINK_CRC_SLICING_BY_4 1
+#define SERIAL_LINK_CRC_SLICING_BY_8 2
+#define SERIAL_LINK_CRC_HARDWARE 3
+
+#ifndef SERIAL_LINK_CRC
+#define SERIAL_LINK_CRC SERIAL_LINK_CRC_TABLE
+#endif
+
+uint32_t crc32_table(const uint8_t* data, uint16_t size);
+uint32_t crc32_slicing_by_4(const uint8_t* data, uint16_t size);
+uint32_t crc32_slicing_by_8(const uint8_t* data, uint16_t size);
+// Implemented by the keyboard for SERIAL_LINK_CRC_HARDWARE. Has to return the
+// same value as crc32_table(), so the peripheral needs the CRC-32 polynomial,
+// bit reversed input and output, 0xFFFFFFFF as the seed, and the result
+// inverted.
+uint32_t crc32_hardware(const uint8_t* data, uint16_t size);
+
+#if SERIAL_LINK_CRC == SERIAL_LINK_CRC_TABLE
+#define serial_link_crc32 crc32_table
+#elif SERIAL_LINK_CRC == SERIAL_LINK_CRC_SLICING_BY_4
+#define serial_link_crc32 crc32_slicing_by_4
+#elif SERIAL_LINK_CRC == SERIAL_LINK_CRC_SLICING_BY_8
+#define serial_link_crc32 crc32_slicing_by_8
+#elif SERIAL_LINK_CRC == SERIAL_LINK_CRC_HARDWARE
+#define serial_link_crc32 crc32_hardware
+#else
+#error "Unknown SERIAL_LINK_CRC"
+#endif
+
+#endif
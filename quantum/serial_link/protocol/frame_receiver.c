@@ -0,0 +1,101 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 Fred Sundvik
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "serial_link/protocol/frame_receiver.h"
+#include <string.h>
+
+typedef struct {
+    // Room to encode the first frame in place again, if it's forwarded
+    uint8_t header[BYTE_STUFFER_HEADER];
+    uint8_t data[FRAME_RECEIVER_SIZE];
+    uint16_t size;
+    // Where the next frame starts, and where the last completed one ends
+    uint16_t start;
+    uint16_t end;
+    // Skipping the rest of a frame that didn't fit
+    bool discarding;
+} frame_receiver_t;
+
+static frame_receiver_t receivers[NUM_LINKS];
+
+void init_frame_receiver(void) {
+    int i;
+    for (i=0;i<NUM_LINKS;i++) {
+        receivers[i].size = 0;
+        receivers[i].start = 0;
+        receivers[i].end = 0;
+        receivers[i].discarding = false;
+    }
+}
+
+uint8_t* frame_receiver_space(uint8_t link, uint16_t* size) {
+    frame_receiver_t* r = &receivers[link];
+    if (r->end > r->start) {
+        frame_receiver_process(link);
+    }
+    if (r->size == FRAME_RECEIVER_SIZE) {
+        // The frame is too long, so drop what we have
+        r->size = 0;
+        r->start = 0;
+        r->end = 0;
+        r->discarding = true;
+    }
+    *size = FRAME_RECEIVER_SIZE - r->size;
+    return r->data + r->size;
+}
+
+bool frame_receiver_received(uint8_t link, uint16_t size) {
+    frame_receiver_t* r = &receivers[link];
+    uint16_t i;
+    for (i = r->size; i < r->size + size; i++) {
+        if (r->data[i] == 0) {
+            if (r->discarding) {
+                r->start = i + 1;
+                r->discarding = false;
+            }
+            r->end = i + 1;
+        }
+    }
+    r->size += size;
+    return r->end > r->start;
+}
+
+void frame_receiver_process(uint8_t link) {
+    frame_receiver_t* r = &receivers[link];
+    uint16_t pos = r->start;
+    while (pos < r->end) {
+        uint16_t used = byte_stuffer_recv_frame(link, r->data + pos, r->end - pos);
+        if (used == 0) {
+            // Only zeroes left
+            break;
+        }
+        pos += used;
+    }
+    // Move the start of the next frame to the beginning
+    uint16_t remaining = r->size - r->end;
+    memmove(r->data, r->data + r->end, remaining);
+    r->size = remaining;
+    r->start = 0;
+    r->end = 0;
+}
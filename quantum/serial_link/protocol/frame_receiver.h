@@ -0,0 +1,48 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 Fred Sundvik
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SERIAL_LINK_FRAME_RECEIVER_H
+#define SERIAL_LINK_FRAME_RECEIVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "serial_link/protocol/byte_stuffer.h"
+
+// Collects the received bytes of each link, so that whole frames can be
+// decoded in place. The physical layer writes the bytes straight into the
+// space it gets, and only needs to process them when a frame is completed.
+// Frames that don't fit are dropped.
+#ifndef FRAME_RECEIVER_SIZE
+#define FRAME_RECEIVER_SIZE (MAX_FRAME_SIZE + BYTE_STUFFER_HEADER + 1)
+#endif
+
+void init_frame_receiver(void);
+// Where the next received bytes should be written, and how many fit
+uint8_t* frame_receiver_space(uint8_t link, uint16_t* size);
+// Returns true if the bytes written to the space completed a frame
+bool frame_receiver_received(uint8_t link, uint16_t size);
+// Decodes and handles all completed frames
+void frame_receiver_process(uint8_t link);
+
+#endif
@@ -33,6 +33,8 @@ SOFTWARE.
 
 void router_set_master(bool master);
 void route_incoming_frame(uint8_t link, uint8_t* data, uint16_t size);
+// The buffer pointed to by the data needs 6 additional bytes, and
+// BYTE_STUFFER_HEADER bytes in front of it
 void router_send_frame(uint8_t destination, uint8_t* data, uint16_t size);
 
 #endif
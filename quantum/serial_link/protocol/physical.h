@@ -25,6 +25,8 @@ SOFTWARE.
 #ifndef SERIAL_LINK_PHYSICAL_H
 #define SERIAL_LINK_PHYSICAL_H
 
+// Implemented by the physical layer, which sends the received bytes
+// through the frame receiver
 void send_data(uint8_t link, const uint8_t* data, uint16_t size);
 
 #endif
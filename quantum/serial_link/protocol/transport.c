@@ -31,6 +31,58 @@ SOFTWARE.
 static remote_object_t* remote_objects[MAX_REMOTE_OBJECTS];
 static uint32_t num_remote_objects = 0;
 
+// Delta encoded frames end with the sequence number and the encoding
+#define DELTA_TRAILER 2
+
+enum {
+    // The whole object
+    DELTA_KEYFRAME,
+    // Pairs of unchanged and changed byte counts, followed by the changed
+    // bytes xored with the previous value
+    DELTA_RUNS,
+    // A bit for each changed byte, followed by the changed bytes xored with
+    // the previous value
+    DELTA_BITMAP,
+};
+
+// The delta states come after the triple buffers, first the local one
+// and then the remote ones
+static uint8_t* get_delta_start(remote_object_t* obj) {
+    uint8_t* start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
+    if (obj->object_type == MASTER_TO_ALL_SLAVES) {
+        return start + REMOTE_OBJECT_SIZE(obj->object_size);
+    }
+    else {
+        return start + NUM_SLAVES * REMOTE_OBJECT_SIZE(obj->object_size);
+    }
+}
+
+static delta_state_t* get_local_delta(remote_object_t* obj) {
+    return (delta_state_t*)get_delta_start(obj);
+}
+
+static delta_state_t* get_remote_delta(remote_object_t* obj, uint8_t index) {
+    uint8_t* start = get_delta_start(obj) + DELTA_LOCAL_SIZE(obj->object_size);
+    return (delta_state_t*)(start + index * DELTA_REMOTE_SIZE(obj->object_size));
+}
+
+static void init_delta_states(remote_object_t* obj) {
+    delta_state_t* state = get_local_delta(obj);
+    // Start with a keyframe
+    state->sequence = 0;
+    state->frames_to_keyframe = 0;
+    state->synced = false;
+    state->keyframe_time = 0;
+    unsigned int num_remote = obj->object_type == MASTER_TO_ALL_SLAVES ? 1 : NUM_SLAVES;
+    unsigned int i;
+    for (i=0;i<num_remote;i++) {
+        state = get_remote_delta(obj, i);
+        state->sequence = 0;
+        state->frames_to_keyframe = 0;
+        state->synced = false;
+    }
+}
+
 void reinitialize_serial_link_transport(void) {
     num_remote_objects = 0;
 }
@@ -70,14 +122,215 @@ void add_remote_objects(remote_object_t** _remote_objects, uint32_t _num_remote_
                 start += REMOTE_OBJECT_SIZE(obj->object_size);
             }
         }
+        if (obj->delta) {
+            init_delta_states(obj);
+        }
     }
 }
 
+// The encoders give up, and return the object size, when the delta
+// wouldn't be smaller than the object itself
+static uint16_t encode_runs(const uint8_t* object, const uint8_t* copy, uint16_t size, uint8_t* out) {
+    uint16_t pos = 0;
+    uint16_t out_pos = 0;
+    while (pos < size) {
+        uint8_t unchanged = 0;
+        while (pos < size && unchanged < 255 && object[pos] == copy[pos]) {
+            unchanged++;
+            pos++;
+        }
+        if (pos == size) {
+            // No need to send the unchanged end
+            break;
+        }
+        uint8_t changed = 0;
+        while (pos + changed < size && changed < 255 && object[pos + changed] != copy[pos + changed]) {
+            changed++;
+        }
+        if (out_pos + 2 + changed >= size) {
+            return size;
+        }
+        out[out_pos++] = unchanged;
+        out[out_pos++] = changed;
+        while (changed--) {
+            out[out_pos++] = object[pos] ^ copy[pos];
+            pos++;
+        }
+    }
+    return out_pos;
+}
+
+static uint16_t encode_bitmap(const uint8_t* object, const uint8_t* copy, uint16_t size, uint8_t* out) {
+    uint16_t bitmap_size = (size + 7) / 8;
+    if (bitmap_size >= size) {
+        return size;
+    }
+    memset(out, 0, bitmap_size);
+    uint16_t out_pos = bitmap_size;
+    uint16_t pos;
+    for (pos=0;pos<size;pos++) {
+        if (object[pos] != copy[pos]) {
+            if (out_pos + 1 >= size) {
+                return size;
+            }
+            out[pos / 8] |= 1 << (pos & 7);
+            out[out_pos++] = object[pos] ^ copy[pos];
+        }
+    }
+    return out_pos;
+}
+
+static uint16_t count_changes(const uint8_t* object, const uint8_t* copy, uint16_t size) {
+    uint16_t changes = 0;
+    uint16_t pos;
+    for (pos=0;pos<size;pos++) {
+        changes += object[pos] != copy[pos];
+    }
+    return changes;
+}
+
+// Returns the frame to send, which is either the object itself or the delta
+// against the previous frame, with room for the lower layers around it
+static uint8_t* encode_delta(remote_object_t* obj, uint8_t* object, uint16_t* frame_size) {
+    uint16_t size = obj->object_size;
+    delta_state_t* state = get_local_delta(obj);
+    uint8_t* copy = (uint8_t*)(state + 1);
+    uint8_t* frame = copy + size + LOCAL_OBJECT_HEADER;
+    uint8_t encoding = DELTA_KEYFRAME;
+    uint16_t encoded_size = size;
+    if (state->frames_to_keyframe > 0) {
+        encoded_size = encode_runs(object, copy, size, frame);
+        encoding = DELTA_RUNS;
+        uint16_t bitmap_size = (size + 7) / 8 + count_changes(object, copy, size);
+        if (bitmap_size < encoded_size) {
+            encoded_size = encode_bitmap(object, copy, size, frame);
+            encoding = DELTA_BITMAP;
+        }
+    }
+    if (encoded_size >= size) {
+        encoding = DELTA_KEYFRAME;
+        encoded_size = size;
+        frame = object;
+        state->frames_to_keyframe = TRANSPORT_KEYFRAME_INTERVAL - 1;
+        state->keyframe_time = transport_time_ms();
+    }
+    else {
+        state->frames_to_keyframe--;
+    }
+    memcpy(copy, object, size);
+    state->synced = true;
+    frame[encoded_size++] = ++state->sequence;
+    frame[encoded_size++] = encoding;
+    *frame_size = encoded_size;
+    return frame;
+}
+
+// Returns the last object sent as a keyframe, when it's time to resend it,
+// or NULL
+static uint8_t* resend_keyframe(remote_object_t* obj, uint16_t* frame_size) {
+    uint16_t size = obj->object_size;
+    delta_state_t* state = get_local_delta(obj);
+    if (!state->synced ||
+        (uint16_t)(transport_time_ms() - state->keyframe_time) < TRANSPORT_KEYFRAME_PERIOD) {
+        return NULL;
+    }
+    uint8_t* copy = (uint8_t*)(state + 1);
+    uint8_t* frame = copy + size + LOCAL_OBJECT_HEADER;
+    memcpy(frame, copy, size);
+    frame[size] = ++state->sequence;
+    frame[size + 1] = DELTA_KEYFRAME;
+    state->frames_to_keyframe = TRANSPORT_KEYFRAME_INTERVAL - 1;
+    state->keyframe_time = transport_time_ms();
+    *frame_size = size + DELTA_TRAILER;
+    return frame;
+}
+
+static bool apply_runs(uint8_t* copy, uint16_t size, const uint8_t* data, uint16_t data_size) {
+    uint16_t pos = 0;
+    uint16_t in = 0;
+    while (in < data_size) {
+        if (data_size - in < 2) {
+            return false;
+        }
+        pos += data[in++];
+        uint8_t changed = data[in++];
+        if (pos + changed > size || data_size - in < changed) {
+            return false;
+        }
+        while (changed--) {
+            copy[pos++] ^= data[in++];
+        }
+    }
+    return true;
+}
+
+static bool apply_bitmap(uint8_t* copy, uint16_t size, const uint8_t* data, uint16_t data_size) {
+    uint16_t bitmap_size = (size + 7) / 8;
+    if (data_size < bitmap_size) {
+        return false;
+    }
+    uint16_t in = bitmap_size;
+    uint16_t pos;
+    for (pos=0;pos<size;pos++) {
+        if (data[pos / 8] & (1 << (pos & 7))) {
+            if (in == data_size) {
+                return false;
+            }
+            copy[pos] ^= data[in++];
+        }
+    }
+    return in == data_size;
+}
+
+// Returns the updated object, or NULL if the frame can't be applied
+static uint8_t* decode_delta(remote_object_t* obj, uint8_t from, uint8_t* data, uint16_t size) {
+    if (size < DELTA_TRAILER) {
+        return NULL;
+    }
+    size -= DELTA_TRAILER;
+    uint8_t sequence = data[size];
+    uint8_t encoding = data[size + 1];
+    delta_state_t* state = get_remote_delta(obj, obj->object_type == SLAVE_TO_MASTER ? from - 1 : 0);
+    uint8_t* copy = (uint8_t*)(state + 1);
+    if (encoding == DELTA_KEYFRAME) {
+        if (size != obj->object_size) {
+            return NULL;
+        }
+        memcpy(copy, data, size);
+        state->synced = true;
+    }
+    else {
+        bool valid = false;
+        // After a lost frame, the deltas are ignored until the next keyframe
+        if (state->synced && sequence == (uint8_t)(state->sequence + 1)) {
+            if (encoding == DELTA_RUNS) {
+                valid = apply_runs(copy, obj->object_size, data, size);
+            }
+            else if (encoding == DELTA_BITMAP) {
+                valid = apply_bitmap(copy, obj->object_size, data, size);
+            }
+        }
+        if (!valid) {
+            state->synced = false;
+            return NULL;
+        }
+    }
+    state->sequence = sequence;
+    return copy;
+}
+
 void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size) {
     uint8_t id = data[size-1];
     if (id < num_remote_objects) {
         remote_object_t* obj = remote_objects[id];
-        if (obj->object_size == size - 1) {
+        uint8_t* object = NULL;
+        if (obj->delta) {
+            object = decode_delta(obj, from, data, size - 1);
+        }
+        else if (obj->object_size == size - 1) {
+            object = data;
+        }
+        if (object) {
             uint8_t* start;
             if (obj->object_type == MASTER_TO_ALL_SLAVES) {
                 start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
@@ -91,7 +344,7 @@ void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size) {
             }
             triple_buffer_object_t* tb = (triple_buffer_object_t*)start;
             void* ptr = triple_buffer_begin_write_internal(obj->object_size, tb);
-            memcpy(ptr, data, size - 1);
+            memcpy(ptr, object, obj->object_size);
             triple_buffer_end_write_internal(tb);
         }
     }
@@ -103,11 +356,21 @@ void update_transport(void) {
         remote_object_t* obj = remote_objects[i];
         if (obj->object_type == MASTER_TO_ALL_SLAVES || obj->object_type == SLAVE_TO_MASTER) {
             triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer;
-            uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size + LOCAL_OBJECT_EXTRA, tb);
+            uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(LOCAL_OBJECT_HEADER + obj->object_size + LOCAL_OBJECT_EXTRA, tb);
+            uint16_t size = obj->object_size;
+            if (ptr) {
+                ptr += LOCAL_OBJECT_HEADER;
+                if (obj->delta) {
+                    ptr = encode_delta(obj, ptr, &size);
+                }
+            }
+            else if (obj->delta) {
+                ptr = resend_keyframe(obj, &size);
+            }
             if (ptr) {
-                ptr[obj->object_size] = i;
+                ptr[size] = i;
                 uint8_t dest = obj->object_type == MASTER_TO_ALL_SLAVES ? 0xFF : 0;
-                router_send_frame(dest, ptr, obj->object_size + 1);
+                router_send_frame(dest, ptr, size + 1);
             }
         }
         else {
@@ -115,8 +378,9 @@ void update_transport(void) {
             unsigned int j;
             for (j=0;j<NUM_SLAVES;j++) {
                 triple_buffer_object_t* tb = (triple_buffer_object_t*)start;
-                uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size + LOCAL_OBJECT_EXTRA, tb);
+                uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(LOCAL_OBJECT_HEADER + obj->object_size + LOCAL_OBJECT_EXTRA, tb);
                 if (ptr) {
+                    ptr += LOCAL_OBJECT_HEADER;
                     ptr[obj->object_size] = i;
                     uint8_t dest = j + 1;
                     router_send_frame(dest, ptr, obj->object_size + 1);
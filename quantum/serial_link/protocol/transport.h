@@ -26,10 +26,25 @@ SOFTWARE.
 #define SERIAL_LINK_TRANSPORT_H
 
 #include "serial_link/protocol/triple_buffered_object.h"
+#include "serial_link/protocol/byte_stuffer.h"
 #include "serial_link/system/serial_link.h"
+#include <stdbool.h>
 
 #define NUM_SLAVES 8
 #define LOCAL_OBJECT_EXTRA 16
+// The local objects are sent in place, so leave room for the byte stuffer
+// in front of them, keeping the alignment
+#define LOCAL_OBJECT_HEADER ((BYTE_STUFFER_HEADER + 3) & ~3)
+// Delta encoded objects are sent in full this often, so that the receivers
+// can recover from lost frames
+#ifndef TRANSPORT_KEYFRAME_INTERVAL
+#define TRANSPORT_KEYFRAME_INTERVAL 32
+#endif
+// And resent as a keyframe after this many milliseconds without changes,
+// so that a lost frame isn't missed until the next change
+#ifndef TRANSPORT_KEYFRAME_PERIOD
+#define TRANSPORT_KEYFRAME_PERIOD 1000
+#endif
 
 // master -> slave = 1 local(target all), 1 remote object
 // slave -> master = 1 local(target 0), multiple remote objects
@@ -43,34 +58,66 @@ typedef enum {
 typedef struct {
     remote_object_type object_type;
     uint16_t object_size;
+    bool delta;
     uint8_t buffer[] __attribute__((aligned(4)));
 } remote_object_t;
 
+// The sequence number of the last frame sent or received, and the sender
+// counts down to the next keyframe and remembers when it last sent one,
+// while the receiver tracks if it has a valid copy to apply the deltas to,
+// and the sender if it has sent one. Followed by that copy.
+typedef struct {
+    uint8_t sequence;
+    uint8_t frames_to_keyframe;
+    bool synced;
+    uint16_t keyframe_time;
+} delta_state_t;
+
+// The parts of an object buffer are rounded up to 4 bytes, so that the
+// triple buffers and delta states after them stay aligned for any object size
+#define TRANSPORT_ALIGN(size) (((size) + 3) & ~3)
 #define REMOTE_OBJECT_SIZE(objectsize) \
-    (sizeof(triple_buffer_object_t) + objectsize * 3)
+    TRANSPORT_ALIGN(sizeof(triple_buffer_object_t) + objectsize * 3)
 #define LOCAL_OBJECT_SIZE(objectsize) \
-    (sizeof(triple_buffer_object_t) + (objectsize + LOCAL_OBJECT_EXTRA) * 3)
-
-#define REMOTE_OBJECT_HELPER(name, type, num_local, num_remote) \
+    TRANSPORT_ALIGN(sizeof(triple_buffer_object_t) + (LOCAL_OBJECT_HEADER + objectsize + LOCAL_OBJECT_EXTRA) * 3)
+// The deltas are encoded into a separate frame, since they can't be encoded in place
+#define DELTA_REMOTE_SIZE(objectsize) \
+    TRANSPORT_ALIGN(sizeof(delta_state_t) + objectsize)
+#define DELTA_LOCAL_SIZE(objectsize) \
+    TRANSPORT_ALIGN(DELTA_REMOTE_SIZE(objectsize) + LOCAL_OBJECT_HEADER + objectsize + LOCAL_OBJECT_EXTRA)
+
+#define REMOTE_OBJECT_HELPER(name, type, num_local, num_remote, delta_encoded) \
 typedef struct { \
-    remote_object_t object; \
+    remote_object_type object_type; \
+    uint16_t object_size; \
+    bool delta; \
     uint8_t buffer[ \
         num_remote * REMOTE_OBJECT_SIZE(sizeof(type)) + \
-        num_local * LOCAL_OBJECT_SIZE(sizeof(type))]; \
+        num_local * LOCAL_OBJECT_SIZE(sizeof(type)) + \
+        (delta_encoded ? num_remote * DELTA_REMOTE_SIZE(sizeof(type)) + \
+            num_local * DELTA_LOCAL_SIZE(sizeof(type)) : 0)] __attribute__((aligned(4))); \
 } remote_object_##name##_t;
 
 #define MASTER_TO_ALL_SLAVES_OBJECT(name, type) \
-    REMOTE_OBJECT_HELPER(name, type, 1, 1) \
+    MASTER_TO_ALL_SLAVES_OBJECT_HELPER(name, type, false)
+
+// Only sends the changes since the last frame, for big objects that change
+// a little at a time
+#define MASTER_TO_ALL_SLAVES_DELTA_OBJECT(name, type) \
+    MASTER_TO_ALL_SLAVES_OBJECT_HELPER(name, type, true)
+
+#define MASTER_TO_ALL_SLAVES_OBJECT_HELPER(name, type, delta_encoded) \
+    REMOTE_OBJECT_HELPER(name, type, 1, 1, delta_encoded) \
     remote_object_##name##_t remote_object_##name = { \
-        .object = { \
-            .object_type = MASTER_TO_ALL_SLAVES, \
-            .object_size = sizeof(type), \
-        } \
+        .object_type = MASTER_TO_ALL_SLAVES, \
+        .object_size = sizeof(type), \
+        .delta = delta_encoded, \
     }; \
     type* begin_write_##name(void) { \
         remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer; \
-        return (type*)triple_buffer_begin_write_internal(sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
+        uint8_t* slot = (uint8_t*)triple_buffer_begin_write_internal(LOCAL_OBJECT_HEADER + sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
+        return (type*)(slot + LOCAL_OBJECT_HEADER); \
     }\
     void end_write_##name(void) { \
         remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
@@ -86,19 +133,18 @@ typedef struct { \
     }
 
 #define MASTER_TO_SINGLE_SLAVE_OBJECT(name, type) \
-    REMOTE_OBJECT_HELPER(name, type, NUM_SLAVES, 1) \
+    REMOTE_OBJECT_HELPER(name, type, NUM_SLAVES, 1, false) \
     remote_object_##name##_t remote_object_##name = { \
-        .object = { \
-            .object_type = MASTER_TO_SINGLE_SLAVE, \
-            .object_size = sizeof(type), \
-        } \
+        .object_type = MASTER_TO_SINGLE_SLAVE, \
+        .object_size = sizeof(type), \
     }; \
     type* begin_write_##name(uint8_t slave) { \
         remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
         uint8_t* start = obj->buffer;\
         start += slave * LOCAL_OBJECT_SIZE(obj->object_size); \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)start; \
-        return (type*)triple_buffer_begin_write_internal(sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
+        uint8_t* slot = (uint8_t*)triple_buffer_begin_write_internal(LOCAL_OBJECT_HEADER + sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
+        return (type*)(slot + LOCAL_OBJECT_HEADER); \
     }\
     void end_write_##name(uint8_t slave) { \
         remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
@@ -116,17 +162,23 @@ typedef struct { \
     }
 
 #define SLAVE_TO_MASTER_OBJECT(name, type) \
-    REMOTE_OBJECT_HELPER(name, type, 1, NUM_SLAVES) \
+    SLAVE_TO_MASTER_OBJECT_HELPER(name, type, false)
+
+#define SLAVE_TO_MASTER_DELTA_OBJECT(name, type) \
+    SLAVE_TO_MASTER_OBJECT_HELPER(name, type, true)
+
+#define SLAVE_TO_MASTER_OBJECT_HELPER(name, type, delta_encoded) \
+    REMOTE_OBJECT_HELPER(name, type, 1, NUM_SLAVES, delta_encoded) \
     remote_object_##name##_t remote_object_##name = { \
-        .object = { \
-            .object_type = SLAVE_TO_MASTER, \
-            .object_size = sizeof(type), \
-        } \
+        .object_type = SLAVE_TO_MASTER, \
+        .object_size = sizeof(type), \
+        .delta = delta_encoded, \
     }; \
     type* begin_write_##name(void) { \
         remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer; \
-        return (type*)triple_buffer_begin_write_internal(sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
+        uint8_t* slot = (uint8_t*)triple_buffer_begin_write_internal(LOCAL_OBJECT_HEADER + sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
+        return (type*)(slot + LOCAL_OBJECT_HEADER); \
     }\
     void end_write_##name(void) { \
         remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
@@ -149,4 +201,7 @@ void reinitialize_serial_link_transport(void);
 void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size);
 void update_transport(void);
 
+// A millisecond clock, implemented by the system layer
+uint16_t transport_time_ms(void);
+
 #endif
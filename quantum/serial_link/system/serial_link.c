@@ -26,9 +26,11 @@ SOFTWARE.
 #include "serial_link/system/serial_link.h"
 #include "hal.h"
 #include "serial_link/protocol/byte_stuffer.h"
+#include "serial_link/protocol/frame_receiver.h"
 #include "serial_link/protocol/transport.h"
 #include "serial_link/protocol/frame_router.h"
 #include "matrix.h"
+#include "timer.h"
 #include <stdbool.h>
 #include "print.h"
 #include "config.h"
@@ -66,15 +68,14 @@ static SerialConfig config = {
 
 //#define DEBUG_LINK_ERRORS
 
+// Reads everything available straight into the frame receiver, and only
+// decodes once a frame is complete
 static uint32_t read_from_serial(SerialDriver* driver, uint8_t link) {
-    const uint32_t buffer_size = 16;
-    uint8_t buffer[buffer_size];
-    uint32_t bytes_read = sdAsynchronousRead(driver, buffer, buffer_size);
-    uint8_t* current = buffer;
-    uint8_t* end = current + bytes_read;
-    while(current < end) {
-        byte_stuffer_recv_byte(link, *current);
-        current++;
+    uint16_t size;
+    uint8_t* buffer = frame_receiver_space(link, &size);
+    uint32_t bytes_read = sdAsynchronousRead(driver, buffer, size);
+    if (frame_receiver_received(link, bytes_read)) {
+        frame_receiver_process(link);
     }
     return bytes_read;
 }
@@ -137,7 +138,8 @@ static THD_FUNCTION(serialThread, arg) {
         eventflags_t flags1 = 0;
         eventflags_t flags2 = 0;
         if (need_wait) {
-            eventmask_t mask = chEvtWaitAnyTimeout(ALL_EVENTS, MS2ST(1000));
+            // Wake up at least when the delta objects are due a keyframe
+            eventmask_t mask = chEvtWaitAnyTimeout(ALL_EVENTS, MS2ST(TRANSPORT_KEYFRAME_PERIOD));
             if (mask & EVENT_MASK(1)) {
                 flags1 = chEvtGetAndClearFlags(&sd1_listener);
                 print_error("DOWNLINK", flags1, &SD1);
@@ -188,7 +190,7 @@ void init_serial_link(void) {
     serial_link_connected = false;
     init_serial_link_hal();
     add_remote_objects(remote_objects, sizeof(remote_objects)/sizeof(remote_object_t*));
-    init_byte_stuffer();
+    init_frame_receiver();
     sdStart(&SD1, &config);
     sdStart(&SD2, &config);
     chEvtObjectInit(&new_data_event);
@@ -234,6 +236,10 @@ void signal_data_written(void) {
     chEvtBroadcast(&new_data_event);
 }
 
+uint16_t transport_time_ms(void) {
+    return timer_read();
+}
+
 bool is_serial_link_connected(void) {
     return serial_link_connected;
 }
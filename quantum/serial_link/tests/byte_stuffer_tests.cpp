@@ -26,6 +26,7 @@ SOFTWARE.
 #include "gmock/gmock.h"
 #include <vector>
 #include <algorithm>
+#include <cstdlib>
 extern "C" {
 #include "serial_link/protocol/byte_stuffer.h"
 #include "serial_link/protocol/frame_validator.h"
@@ -51,8 +52,20 @@ public:
 
     void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
         std::copy(data, data + size, std::back_inserter(sent_data));
+        sent_from = data;
+        num_sends++;
     }
+
+    // The frame is encoded in place, so send a copy with room for that
+    void send_frame(uint8_t link, const uint8_t* data, uint16_t size) {
+        std::vector<uint8_t> buffer(BYTE_STUFFER_HEADER + size + 1);
+        std::copy(data, data + size, buffer.begin() + BYTE_STUFFER_HEADER);
+        byte_stuffer_send_frame(link, buffer.data() + BYTE_STUFFER_HEADER, size);
+    }
+
     std::vector<uint8_t> sent_data;
+    const uint8_t* sent_from = nullptr;
+    int num_sends = 0;
 
     static ByteStuffer* Instance;
 };
@@ -303,61 +316,61 @@ TEST_F(ByteStuffer, received_frame_is_aborted_when_its_too_long) {
 
 TEST_F(ByteStuffer, does_nothing_when_sending_zero_size_frame) {
     EXPECT_EQ(sent_data.size(), 0);
-    byte_stuffer_send_frame(0, NULL, 0);
+    send_frame(0, NULL, 0);
 }
 
 TEST_F(ByteStuffer, send_one_byte_frame) {
     uint8_t data[] = {5};
-    byte_stuffer_send_frame(1, data, 1);
+    send_frame(1, data, 1);
     uint8_t expected[] = {2, 5, 0};
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
 
 TEST_F(ByteStuffer, sends_two_byte_frame) {
     uint8_t data[] = {5, 0x77};
-    byte_stuffer_send_frame(0, data, 2);
+    send_frame(0, data, 2);
     uint8_t expected[] = {3, 5, 0x77, 0};
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
 
 TEST_F(ByteStuffer, sends_one_byte_frame_with_zero) {
     uint8_t data[] = {0};
-    byte_stuffer_send_frame(0, data, 1);
+    send_frame(0, data, 1);
     uint8_t expected[] = {1, 1, 0};
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
 
 TEST_F(ByteStuffer, sends_two_byte_frame_starting_with_zero) {
     uint8_t data[] = {0, 9};
-    byte_stuffer_send_frame(1, data, 2);
+    send_frame(1, data, 2);
     uint8_t expected[] = {1, 2, 9, 0};
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
 
 TEST_F(ByteStuffer, sends_two_byte_frame_starting_with_non_zero) {
     uint8_t data[] = {9, 0};
-    byte_stuffer_send_frame(1, data, 2);
+    send_frame(1, data, 2);
     uint8_t expected[] = {2, 9, 1, 0};
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
 
 TEST_F(ByteStuffer, sends_three_byte_frame_zero_in_the_middle) {
     uint8_t data[] = {9, 0, 0x68};
-    byte_stuffer_send_frame(0, data, 3);
+    send_frame(0, data, 3);
     uint8_t expected[] = {2, 9, 2, 0x68, 0};
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
 
 TEST_F(ByteStuffer, sends_three_byte_frame_data_in_the_middle) {
     uint8_t data[] = {0, 0x55, 0};
-    byte_stuffer_send_frame(0, data, 3);
+    send_frame(0, data, 3);
     uint8_t expected[] = {1, 2, 0x55, 1, 0};
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
 
 TEST_F(ByteStuffer, sends_three_byte_frame_with_all_zeroes) {
     uint8_t data[] = {0, 0, 0};
-    byte_stuffer_send_frame(0, data, 3);
+    send_frame(0, data, 3);
     uint8_t expected[] = {1, 1, 1, 1, 0};
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
@@ -368,7 +381,7 @@ TEST_F(ByteStuffer, sends_frame_with_254_non_zeroes) {
     for(i=0;i<254;i++) {
         data[i] = i + 1;
     }
-    byte_stuffer_send_frame(0, data, 254);
+    send_frame(0, data, 254);
     uint8_t expected[256];
     expected[0] = 0xFF;
     for(i=1;i<255;i++) {
@@ -384,7 +397,7 @@ TEST_F(ByteStuffer, sends_frame_with_255_non_zeroes) {
     for(i=0;i<255;i++) {
         data[i] = i + 1;
     }
-    byte_stuffer_send_frame(0, data, 255);
+    send_frame(0, data, 255);
     uint8_t expected[258];
     expected[0] = 0xFF;
     for(i=1;i<255;i++) {
@@ -403,7 +416,7 @@ TEST_F(ByteStuffer, sends_frame_with_254_non_zeroes_followed_by_zero) {
         data[i] = i + 1;
     }
     data[254] = 0;
-    byte_stuffer_send_frame(0, data, 255);
+    send_frame(0, data, 255);
     uint8_t expected[258];
     expected[0] = 0xFF;
     for(i=1;i<255;i++) {
@@ -417,7 +430,7 @@ TEST_F(ByteStuffer, sends_frame_with_254_non_zeroes_followed_by_zero) {
 
 TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_small_packet) {
     uint8_t original_data[] = { 1, 2, 3};
-    byte_stuffer_send_frame(0, original_data, sizeof(original_data));
+    send_frame(0, original_data, sizeof(original_data));
     EXPECT_CALL(*this, validator_recv_frame(_, _, _))
         .With(Args<1, 2>(ElementsAreArray(original_data)));
     int i;
@@ -428,7 +441,7 @@ TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_small_packet) {
 
 TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_small_packet_with_zeros) {
     uint8_t original_data[] = { 1, 0, 3, 0, 0, 9};
-    byte_stuffer_send_frame(1, original_data, sizeof(original_data));
+    send_frame(1, original_data, sizeof(original_data));
     EXPECT_CALL(*this, validator_recv_frame(_, _, _))
         .With(Args<1, 2>(ElementsAreArray(original_data)));
     int i;
@@ -443,7 +456,7 @@ TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_254_bytes) {
     for(i=0;i<254;i++) {
         original_data[i] = i + 1;
     }
-    byte_stuffer_send_frame(0, original_data, sizeof(original_data));
+    send_frame(0, original_data, sizeof(original_data));
     EXPECT_CALL(*this, validator_recv_frame(_, _, _))
         .With(Args<1, 2>(ElementsAreArray(original_data)));
     for(auto& d : sent_data) {
@@ -459,7 +472,7 @@ TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_256_bytes) {
     }
     original_data[254] = 22;
     original_data[255] = 23;
-    byte_stuffer_send_frame(0, original_data, sizeof(original_data));
+    send_frame(0, original_data, sizeof(original_data));
     EXPECT_CALL(*this, validator_recv_frame(_, _, _))
         .With(Args<1, 2>(ElementsAreArray(original_data)));
     for(auto& d : sent_data) {
@@ -474,10 +487,151 @@ TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_254_bytes_and_then_zero) {
         original_data[i] = i + 1;
     }
     original_data[254] = 0;
-    byte_stuffer_send_frame(0, original_data, sizeof(original_data));
+    send_frame(0, original_data, sizeof(original_data));
     EXPECT_CALL(*this, validator_recv_frame(_, _, _))
         .With(Args<1, 2>(ElementsAreArray(original_data)));
     for(auto& d : sent_data) {
        byte_stuffer_recv_byte(1, d);
     }
 }
+
+// The encoder from before frames were encoded in place
+static std::vector<uint8_t> reference_encode(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> out;
+    size_t start = 0;
+    uint16_t num_non_zero = 1;
+    size_t i = 0;
+    auto send_block = [&](size_t end) {
+        out.push_back(num_non_zero);
+        out.insert(out.end(), data.begin() + start, data.begin() + end);
+    };
+    while (i < data.size()) {
+        if (num_non_zero == 0xFF) {
+            send_block(i);
+            start = i;
+            num_non_zero = 1;
+        }
+        else {
+            if (data[i] == 0) {
+                send_block(i);
+                start = i + 1;
+                num_non_zero = 1;
+            }
+            else {
+                num_non_zero++;
+            }
+            ++i;
+        }
+    }
+    send_block(i);
+    out.push_back(0);
+    return out;
+}
+
+static std::vector<uint8_t> random_frame(uint16_t size, int zero_chance) {
+    std::vector<uint8_t> data(size);
+    for (auto& d : data) {
+        d = rand() % 100 < zero_chance ? 0 : rand() % 255 + 1;
+    }
+    return data;
+}
+
+TEST_F(ByteStuffer, sends_the_whole_frame_with_a_single_call_from_the_header) {
+    uint8_t buffer[BYTE_STUFFER_HEADER + 300 + 1];
+    uint8_t* data = buffer + BYTE_STUFFER_HEADER;
+    int i;
+    for(i=0;i<300;i++) {
+        data[i] = i % 7 ? i : 0;
+    }
+    byte_stuffer_send_frame(0, data, 300);
+    EXPECT_EQ(num_sends, 1);
+    EXPECT_EQ(sent_from, buffer);
+}
+
+TEST_F(ByteStuffer, sends_the_same_bytes_as_the_reference_encoder) {
+    srand(1);
+    const int zero_chances[] = {0, 1, 10, 50, 100};
+    for (int zero_chance : zero_chances) {
+        for (uint16_t size = 1; size <= MAX_FRAME_SIZE; size += 37) {
+            std::vector<uint8_t> data = random_frame(size, zero_chance);
+            sent_data.clear();
+            send_frame(0, data.data(), size);
+            ASSERT_EQ(sent_data, reference_encode(data)) << "size " << size << ", zero chance " << zero_chance;
+        }
+    }
+}
+
+TEST_F(ByteStuffer, receives_a_whole_frame_in_place) {
+    uint8_t original_data[] = { 1, 0, 3, 0, 0, 9};
+    send_frame(0, original_data, sizeof(original_data));
+    std::vector<uint8_t> buffer(BYTE_STUFFER_HEADER);
+    buffer.insert(buffer.end(), sent_data.begin(), sent_data.end());
+    uint8_t* data = buffer.data() + BYTE_STUFFER_HEADER;
+    EXPECT_CALL(*this, validator_recv_frame(1, data, sizeof(original_data)))
+        .With(Args<1, 2>(ElementsAreArray(original_data)));
+    EXPECT_EQ(byte_stuffer_recv_frame(1, data, sent_data.size()), sent_data.size());
+}
+
+TEST_F(ByteStuffer, receives_the_first_of_two_frames) {
+    uint8_t first[] = { 7, 0, 8};
+    uint8_t second[] = { 0, 1};
+    send_frame(0, first, sizeof(first));
+    uint16_t first_size = sent_data.size();
+    send_frame(0, second, sizeof(second));
+    {
+        testing::InSequence s;
+        EXPECT_CALL(*this, validator_recv_frame(_, _, _))
+            .With(Args<1, 2>(ElementsAreArray(first)));
+        EXPECT_CALL(*this, validator_recv_frame(_, _, _))
+            .With(Args<1, 2>(ElementsAreArray(second)));
+    }
+    uint16_t used = byte_stuffer_recv_frame(0, sent_data.data(), sent_data.size());
+    EXPECT_EQ(used, first_size);
+    EXPECT_EQ(byte_stuffer_recv_frame(0, sent_data.data() + used, sent_data.size() - used), sent_data.size() - used);
+}
+
+TEST_F(ByteStuffer, receives_nothing_from_an_incomplete_frame) {
+    uint8_t data[] = {4, 1, 2};
+    EXPECT_CALL(*this, validator_recv_frame(_, _, _))
+        .Times(0);
+    EXPECT_EQ(byte_stuffer_recv_frame(0, data, sizeof(data)), 0);
+}
+
+TEST_F(ByteStuffer, receives_nothing_from_an_invalid_frame) {
+    uint8_t data[] = {4, 1, 0, 2, 5, 0};
+    EXPECT_CALL(*this, validator_recv_frame(_, _, _))
+        .Times(0);
+    EXPECT_EQ(byte_stuffer_recv_frame(0, data, sizeof(data)), 3);
+}
+
+TEST_F(ByteStuffer, receives_the_same_frames_a_byte_and_a_frame_at_a_time) {
+    srand(2);
+    std::vector<std::vector<uint8_t>> by_byte;
+    std::vector<std::vector<uint8_t>> by_frame;
+    EXPECT_CALL(*this, validator_recv_frame(0, _, _))
+        .WillRepeatedly(testing::Invoke([&](uint8_t, uint8_t* data, uint16_t size) {
+            by_byte.emplace_back(data, data + size);
+        }));
+    EXPECT_CALL(*this, validator_recv_frame(1, _, _))
+        .WillRepeatedly(testing::Invoke([&](uint8_t, uint8_t* data, uint16_t size) {
+            by_frame.emplace_back(data, data + size);
+        }));
+    const int zero_chances[] = {0, 1, 10, 50, 100};
+    for (int zero_chance : zero_chances) {
+        for (uint16_t size = 1; size <= MAX_FRAME_SIZE; size += 53) {
+            std::vector<uint8_t> data = random_frame(size, zero_chance);
+            send_frame(0, data.data(), size);
+        }
+    }
+    for (auto& d : sent_data) {
+       byte_stuffer_recv_byte(0, d);
+    }
+    uint16_t pos = 0;
+    while (pos < sent_data.size()) {
+        uint16_t used = byte_stuffer_recv_frame(1, sent_data.data() + pos, sent_data.size() - pos);
+        ASSERT_GT(used, 0);
+        pos += used;
+    }
+    EXPECT_EQ(by_byte.size(), 5 * ((MAX_FRAME_SIZE - 1) / 53 + 1));
+    EXPECT_EQ(by_frame, by_byte);
+}
@@ -0,0 +1,179 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 Fred Sundvik
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <vector>
+extern "C" {
+#include "serial_link/protocol/byte_stuffer.h"
+#include "serial_link/protocol/frame_receiver.h"
+#include "serial_link/protocol/frame_router.h"
+#include "serial_link/protocol/transport.h"
+}
+#include "simulated_physical.hpp"
+
+struct test_object {
+    uint8_t data[40];
+};
+
+MASTER_TO_ALL_SLAVES_OBJECT(test, test_object);
+
+static remote_object_t* test_remote_objects[] = {
+    REMOTE_OBJECT(test),
+};
+
+// The same stack plays both the master and the first slave, the master
+// sends on its down link, which is connected to the up link of the slave
+class FrameReceiver : public testing::Test {
+public:
+    FrameReceiver() :
+        physical(1)
+    {
+        Instance = this;
+        init_frame_receiver();
+        add_remote_objects(test_remote_objects, sizeof(test_remote_objects) / sizeof(remote_object_t*));
+    }
+
+    ~FrameReceiver() {
+        Instance = nullptr;
+        reinitialize_serial_link_transport();
+    }
+
+    void send(const test_object& object) {
+        router_set_master(true);
+        is_master_sending = true;
+        *begin_write_test() = object;
+        end_write_test();
+        update_transport();
+        router_set_master(false);
+        is_master_sending = false;
+    }
+
+    void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
+        // The slave forwards to the next one, which isn't connected
+        if (link == DOWN_LINK && is_master_sending) {
+            physical.send(data, size);
+        }
+    }
+
+    test_object make_object(uint8_t seed) {
+        test_object object;
+        for (uint8_t i = 0; i < sizeof(object.data); i++) {
+            object.data[i] = seed * 7 + i * (seed | 1);
+        }
+        return object;
+    }
+
+    SimulatedPhysical physical;
+    bool is_master_sending = false;
+
+    static FrameReceiver* Instance;
+};
+
+FrameReceiver* FrameReceiver::Instance = nullptr;
+
+extern "C" {
+    void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
+        FrameReceiver::Instance->send_data(link, data, size);
+    }
+
+    void signal_data_written(void) {
+    }
+
+    uint16_t transport_time_ms(void) {
+        return 0;
+    }
+}
+
+TEST_F(FrameReceiver, wakes_up_only_when_a_frame_is_complete) {
+    send(make_object(1));
+    size_t frame_size = physical.wire.size();
+    size_t i;
+    for (i = 0; i < frame_size - 1; i++) {
+        physical.deliver_burst(UP_LINK);
+        EXPECT_EQ(physical.wakeups, 0);
+    }
+    physical.deliver_burst(UP_LINK);
+    EXPECT_EQ(physical.wakeups, 1);
+    test_object* received = read_test();
+    ASSERT_NE(received, nullptr);
+    test_object expected = make_object(1);
+    EXPECT_EQ(memcmp(received, &expected, sizeof(expected)), 0);
+}
+
+TEST_F(FrameReceiver, receives_frames_arriving_in_random_bursts) {
+    physical.max_burst = 100;
+    int i;
+    for (i = 0; i < 200; i++) {
+        test_object object = make_object(i);
+        send(object);
+        // Sometimes a few frames arrive together
+        if (i % 3 == 0) {
+            continue;
+        }
+        physical.deliver_all(UP_LINK);
+        test_object* received = read_test();
+        ASSERT_NE(received, nullptr) << "frame " << i;
+        EXPECT_EQ(memcmp(received, &object, sizeof(object)), 0) << "frame " << i;
+    }
+    EXPECT_LE(physical.wakeups, 200);
+}
+
+TEST_F(FrameReceiver, never_receives_corrupted_objects) {
+    physical.max_burst = 20;
+    physical.bit_error_rate = 0.0005;
+    int num_received = 0;
+    int i;
+    for (i = 0; i < 1000; i++) {
+        test_object object = make_object(i);
+        send(object);
+        physical.deliver_all(UP_LINK);
+        test_object* received = read_test();
+        if (received) {
+            EXPECT_EQ(memcmp(received, &object, sizeof(object)), 0) << "frame " << i;
+            num_received++;
+        }
+    }
+    EXPECT_GT(physical.bit_errors, 100);
+    // Each error only loses the frames it hits
+    EXPECT_GT(num_received, 1000 - physical.bit_errors * 2);
+    EXPECT_LT(num_received, 1000);
+}
+
+TEST_F(FrameReceiver, drops_frames_that_dont_fit_and_recovers) {
+    physical.max_burst = 64;
+    std::vector<uint8_t> garbage(FRAME_RECEIVER_SIZE + 100, 0x55);
+    physical.send(garbage.data(), garbage.size());
+    physical.deliver_all(UP_LINK);
+    EXPECT_EQ(read_test(), nullptr);
+    // The frame is completed after it was dropped
+    uint8_t zero = 0;
+    physical.send(&zero, 1);
+    test_object object = make_object(9);
+    send(object);
+    physical.deliver_all(UP_LINK);
+    test_object* received = read_test();
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(memcmp(received, &object, sizeof(object)), 0);
+}
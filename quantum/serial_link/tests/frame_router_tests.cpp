@@ -97,6 +97,7 @@ FrameRouter* FrameRouter::Instance = nullptr;
 
 
 typedef struct {
+    uint8_t header[BYTE_STUFFER_HEADER];
     std::array<uint8_t, 4> data;
     uint8_t extra[16];
 } frame_buffer_t;
@@ -115,19 +116,20 @@ extern "C" {
 
 TEST_F(FrameRouter, master_broadcast_is_received_by_everyone) {
     frame_buffer_t data;
-    data.data = {0xAB, 0x70, 0x55, 0xBB};
+    std::array<uint8_t, 4> expected = {0xAB, 0x70, 0x55, 0xBB};
+    data.data = expected;
     activate_router(0);
-    router_send_frame(0xFF, (uint8_t*)&data, 4);
+    router_send_frame(0xFF, data.data.data(), 4);
     EXPECT_GT(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
     EXPECT_CALL(*this, transport_recv_frame(0, _, _))
-        .With(Args<1, 2>(ElementsAreArray(data.data)));
+        .With(Args<1, 2>(ElementsAreArray(expected)));
     simulate_transport(0, 1);
     EXPECT_GT(router_buffers[1].send_buffers[DOWN_LINK].size(), 0);
     EXPECT_EQ(router_buffers[1].send_buffers[UP_LINK].size(), 0);
 
     EXPECT_CALL(*this, transport_recv_frame(0, _, _))
-        .With(Args<1, 2>(ElementsAreArray(data.data)));
+        .With(Args<1, 2>(ElementsAreArray(expected)));
     simulate_transport(1, 2);
     EXPECT_GT(router_buffers[2].send_buffers[DOWN_LINK].size(), 0);
     EXPECT_EQ(router_buffers[2].send_buffers[UP_LINK].size(), 0);
@@ -135,9 +137,10 @@ TEST_F(FrameRouter, master_broadcast_is_received_by_everyone) {
 
 TEST_F(FrameRouter, master_send_is_received_by_targets) {
     frame_buffer_t data;
-    data.data = {0xAB, 0x70, 0x55, 0xBB};
+    std::array<uint8_t, 4> expected = {0xAB, 0x70, 0x55, 0xBB};
+    data.data = expected;
     activate_router(0);
-    router_send_frame((1 << 1) | (1 << 2), (uint8_t*)&data, 4);
+    router_send_frame((1 << 1) | (1 << 2), data.data.data(), 4);
     EXPECT_GT(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
 
@@ -146,13 +149,13 @@ TEST_F(FrameRouter, master_send_is_received_by_targets) {
     EXPECT_EQ(router_buffers[1].send_buffers[UP_LINK].size(), 0);
 
     EXPECT_CALL(*this, transport_recv_frame(0, _, _))
-        .With(Args<1, 2>(ElementsAreArray(data.data)));
+        .With(Args<1, 2>(ElementsAreArray(expected)));
     simulate_transport(1, 2);
     EXPECT_GT(router_buffers[2].send_buffers[DOWN_LINK].size(), 0);
     EXPECT_EQ(router_buffers[2].send_buffers[UP_LINK].size(), 0);
 
     EXPECT_CALL(*this, transport_recv_frame(0, _, _))
-        .With(Args<1, 2>(ElementsAreArray(data.data)));
+        .With(Args<1, 2>(ElementsAreArray(expected)));
     simulate_transport(2, 3);
     EXPECT_GT(router_buffers[3].send_buffers[DOWN_LINK].size(), 0);
     EXPECT_EQ(router_buffers[3].send_buffers[UP_LINK].size(), 0);
@@ -160,14 +163,15 @@ TEST_F(FrameRouter, master_send_is_received_by_targets) {
 
 TEST_F(FrameRouter, first_link_sends_to_master) {
     frame_buffer_t data;
-    data.data = {0xAB, 0x70, 0x55, 0xBB};
+    std::array<uint8_t, 4> expected = {0xAB, 0x70, 0x55, 0xBB};
+    data.data = expected;
     activate_router(1);
-    router_send_frame(0, (uint8_t*)&data, 4);
+    router_send_frame(0, data.data.data(), 4);
     EXPECT_GT(router_buffers[1].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[1].send_buffers[DOWN_LINK].size(), 0);
 
     EXPECT_CALL(*this, transport_recv_frame(1, _, _))
-        .With(Args<1, 2>(ElementsAreArray(data.data)));
+        .With(Args<1, 2>(ElementsAreArray(expected)));
     simulate_transport(1, 0);
     EXPECT_EQ(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
@@ -175,9 +179,10 @@ TEST_F(FrameRouter, first_link_sends_to_master) {
 
 TEST_F(FrameRouter, second_link_sends_to_master) {
     frame_buffer_t data;
-    data.data = {0xAB, 0x70, 0x55, 0xBB};
+    std::array<uint8_t, 4> expected = {0xAB, 0x70, 0x55, 0xBB};
+    data.data = expected;
     activate_router(2);
-    router_send_frame(0, (uint8_t*)&data, 4);
+    router_send_frame(0, data.data.data(), 4);
     EXPECT_GT(router_buffers[2].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[2].send_buffers[DOWN_LINK].size(), 0);
 
@@ -186,7 +191,7 @@ TEST_F(FrameRouter, second_link_sends_to_master) {
     EXPECT_EQ(router_buffers[1].send_buffers[DOWN_LINK].size(), 0);
 
     EXPECT_CALL(*this, transport_recv_frame(2, _, _))
-        .With(Args<1, 2>(ElementsAreArray(data.data)));
+        .With(Args<1, 2>(ElementsAreArray(expected)));
     simulate_transport(1, 0);
     EXPECT_EQ(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
@@ -194,27 +199,30 @@ TEST_F(FrameRouter, second_link_sends_to_master) {
 
 TEST_F(FrameRouter, master_sends_to_master_does_nothing) {
     frame_buffer_t data;
-    data.data = {0xAB, 0x70, 0x55, 0xBB};
+    std::array<uint8_t, 4> expected = {0xAB, 0x70, 0x55, 0xBB};
+    data.data = expected;
     activate_router(0);
-    router_send_frame(0, (uint8_t*)&data, 4);
+    router_send_frame(0, data.data.data(), 4);
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
 }
 
 TEST_F(FrameRouter, link_sends_to_other_link_does_nothing) {
     frame_buffer_t data;
-    data.data = {0xAB, 0x70, 0x55, 0xBB};
+    std::array<uint8_t, 4> expected = {0xAB, 0x70, 0x55, 0xBB};
+    data.data = expected;
     activate_router(1);
-    router_send_frame(2, (uint8_t*)&data, 4);
+    router_send_frame(2, data.data.data(), 4);
     EXPECT_EQ(router_buffers[1].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[1].send_buffers[DOWN_LINK].size(), 0);
 }
 
 TEST_F(FrameRouter, master_receives_on_uplink_does_nothing) {
     frame_buffer_t data;
-    data.data = {0xAB, 0x70, 0x55, 0xBB};
+    std::array<uint8_t, 4> expected = {0xAB, 0x70, 0x55, 0xBB};
+    data.data = expected;
     activate_router(1);
-    router_send_frame(0, (uint8_t*)&data, 4);
+    router_send_frame(0, data.data.data(), 4);
     EXPECT_GT(router_buffers[1].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[1].send_buffers[DOWN_LINK].size(), 0);
 
@@ -227,3 +235,24 @@ TEST_F(FrameRouter, master_receives_on_uplink_does_nothing) {
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
 }
+
+TEST_F(FrameRouter, frames_received_in_place_are_forwarded_byte_for_byte) {
+    frame_buffer_t data;
+    std::array<uint8_t, 4> expected = {0xAB, 0x00, 0x55, 0xBB};
+    data.data = expected;
+    activate_router(0);
+    router_send_frame(0xFF, data.data.data(), 4);
+    std::vector<uint8_t>& sent = router_buffers[0].send_buffers[DOWN_LINK];
+
+    EXPECT_CALL(*this, transport_recv_frame(0, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expected)))
+        .Times(2);
+    simulate_transport(0, 1);
+    std::vector<uint8_t> forwarded = router_buffers[1].send_buffers[DOWN_LINK];
+    router_buffers[1].send_buffers[DOWN_LINK].clear();
+
+    std::vector<uint8_t> buffer(BYTE_STUFFER_HEADER);
+    buffer.insert(buffer.end(), sent.begin(), sent.end());
+    EXPECT_EQ(byte_stuffer_recv_frame(UP_LINK, buffer.data() + BYTE_STUFFER_HEADER, sent.size()), sent.size());
+    EXPECT_EQ(router_buffers[1].send_buffers[DOWN_LINK], forwarded);
+}
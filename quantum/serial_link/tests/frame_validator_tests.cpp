@@ -24,8 +24,12 @@ SOFTWARE.
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <chrono>
+#include <cstdio>
 extern "C" {
 #include "serial_link/protocol/frame_validator.h"
+#include "serial_link/protocol/crc32.h"
+extern const uint32_t poly8_lookup[256];
 }
 
 using testing::_;
@@ -113,3 +117,67 @@ TEST_F(FrameValidator, sends_five_bytes_with_correct_crc) {
         .With(Args<1, 2>(ElementsAreArray(expected)));
     validator_send_frame(0, original, 5);
 }
+
+// The byte at a time implementation the backends replace
+static uint32_t reference_crc32(const uint8_t* p, uint32_t bytelength) {
+    uint32_t crc = 0xffffffff;
+    while (bytelength-- != 0) crc = poly8_lookup[((uint8_t) crc ^ *(p++))] ^ (crc >> 8);
+    return (crc ^ 0xffffffff);
+}
+
+typedef uint32_t (*crc32_backend_t)(const uint8_t* data, uint16_t size);
+
+static const struct {
+    const char* name;
+    crc32_backend_t crc32;
+} backends[] = {
+    {"table", crc32_table},
+    {"slicing by 4", crc32_slicing_by_4},
+    {"slicing by 8", crc32_slicing_by_8},
+};
+
+TEST(Crc32, backends_match_the_reference_for_every_size_and_alignment) {
+    uint8_t data[520];
+    uint32_t seed = 1;
+    for (uint8_t& byte : data) {
+        seed = seed * 1103515245 + 12345;
+        byte = seed >> 16;
+    }
+    for (auto& backend : backends) {
+        for (uint16_t offset = 0; offset < 8; offset++) {
+            for (uint16_t size = 0; size <= 512; size++) {
+                ASSERT_EQ(backend.crc32(data + offset, size), reference_crc32(data + offset, size))
+                    << backend.name << ", " << size << " bytes at offset " << offset;
+            }
+        }
+    }
+}
+
+TEST(Crc32, backends_give_the_standard_check_value) {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    for (auto& backend : backends) {
+        EXPECT_EQ(backend.crc32(check, sizeof(check)), 0xCBF43926) << backend.name;
+    }
+}
+
+TEST(Crc32, throughput) {
+    static uint8_t data[1024];
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = i * 7;
+    }
+    const uint16_t sizes[] = {16, 64, 1024};
+    for (uint16_t size : sizes) {
+        for (auto& backend : backends) {
+            const unsigned iterations = 1000000 / size;
+            volatile uint32_t sink = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (unsigned i = 0; i < iterations; i++) {
+                sink = sink + backend.crc32(data, size);
+            }
+            auto end = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            printf("%4u byte frames, %-12s: %7.1f MB/s\n", size, backend.name,
+                (double)iterations * size / seconds / 1e6);
+        }
+    }
+}
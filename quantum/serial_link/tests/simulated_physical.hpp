@@ -0,0 +1,94 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 Fred Sundvik
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SERIAL_LINK_SIMULATED_PHYSICAL_HPP
+#define SERIAL_LINK_SIMULATED_PHYSICAL_HPP
+
+#include <algorithm>
+#include <deque>
+#include <random>
+extern "C" {
+#include "serial_link/protocol/frame_receiver.h"
+}
+
+// A wire between two links, standing in for the UART. The bytes arrive in
+// bursts of random size, like they do with interrupt or dma latency, and
+// the bits can be flipped on the way.
+class SimulatedPhysical {
+public:
+    SimulatedPhysical(unsigned seed) :
+        random(seed)
+    {
+    }
+
+    void send(const uint8_t* data, uint16_t size) {
+        std::bernoulli_distribution bit_error(bit_error_rate);
+        for (uint16_t i = 0; i < size; i++) {
+            uint8_t byte = data[i];
+            for (int bit = 0; bit < 8; bit++) {
+                if (bit_error_rate > 0 && bit_error(random)) {
+                    byte ^= 1 << bit;
+                    bit_errors++;
+                }
+            }
+            wire.push_back(byte);
+        }
+    }
+
+    // Delivers one burst to the frame receiver of the link, and returns
+    // false when the wire is empty
+    bool deliver_burst(uint8_t link) {
+        if (wire.empty()) {
+            return false;
+        }
+        std::uniform_int_distribution<uint16_t> burst_size(1, max_burst);
+        uint16_t space;
+        uint8_t* buffer = frame_receiver_space(link, &space);
+        uint16_t size = std::min<size_t>({(size_t)burst_size(random), (size_t)space, wire.size()});
+        std::copy(wire.begin(), wire.begin() + size, buffer);
+        wire.erase(wire.begin(), wire.begin() + size);
+        if (frame_receiver_received(link, size)) {
+            wakeups++;
+            frame_receiver_process(link);
+        }
+        return true;
+    }
+
+    void deliver_all(uint8_t link) {
+        while (deliver_burst(link)) {
+        }
+    }
+
+    double bit_error_rate = 0;
+    uint16_t max_burst = 1;
+    unsigned bit_errors = 0;
+    // The times the receiving thread would have been woken up
+    unsigned wakeups = 0;
+    std::deque<uint8_t> wire;
+
+private:
+    std::mt19937 random;
+};
+
+#endif
@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <cstdlib>
+#include <cstring>
 
 using testing::_;
 using testing::ElementsAreArray;
@@ -42,14 +44,22 @@ struct test_object2 {
     uint32_t test2;
 };
 
+struct test_object3 {
+    uint8_t leds[200];
+};
+
 MASTER_TO_ALL_SLAVES_OBJECT(master_to_slave, test_object1);
 MASTER_TO_SINGLE_SLAVE_OBJECT(master_to_single_slave, test_object1);
 SLAVE_TO_MASTER_OBJECT(slave_to_master, test_object1);
+MASTER_TO_ALL_SLAVES_DELTA_OBJECT(master_to_slave_delta, test_object3);
+SLAVE_TO_MASTER_DELTA_OBJECT(slave_to_master_delta, test_object3);
 
 static remote_object_t* test_remote_objects[] = {
     REMOTE_OBJECT(master_to_slave),
     REMOTE_OBJECT(master_to_single_slave),
     REMOTE_OBJECT(slave_to_master),
+    REMOTE_OBJECT(master_to_slave_delta),
+    REMOTE_OBJECT(slave_to_master_delta),
 };
 
 class Transport : public testing::Test {
@@ -70,11 +80,28 @@ public:
     void router_send_frame(uint8_t destination, uint8_t* data, uint16_t size) {
         router_send_frame(destination);
         std::copy(data, data + size, std::back_inserter(sent_data));
+        sent_frames.emplace_back(data, data + size);
+        // The lower layers use the space around the frame, the router byte,
+        // crc and byte stuffing
+        std::fill(data - BYTE_STUFFER_HEADER, data, 0xEE);
+        std::fill(data + size, data + size + 6, 0xEE);
     }
 
     static Transport* Instance;
 
+    // Writes the leds, sends them, and returns the frame
+    std::vector<uint8_t> send_leds(const test_object3& leds) {
+        *begin_write_master_to_slave_delta() = leds;
+        end_write_master_to_slave_delta();
+        sent_frames.clear();
+        update_transport();
+        EXPECT_EQ(sent_frames.size(), 1);
+        return sent_frames.back();
+    }
+
     std::vector<uint8_t> sent_data;
+    std::vector<std::vector<uint8_t>> sent_frames;
+    uint16_t time_ms = 0;
 };
 
 Transport* Transport::Instance = nullptr;
@@ -87,6 +114,10 @@ void signal_data_written(void) {
 void router_send_frame(uint8_t destination, uint8_t* data, uint16_t size) {
     Transport::Instance->router_send_frame(destination, data, size);
 }
+
+uint16_t transport_time_ms(void) {
+    return Transport::Instance->time_ms;
+}
 }
 
 TEST_F(Transport, write_to_local_signals_an_event) {
@@ -186,3 +217,214 @@ TEST_F(Transport, ignores_object_with_size_too_big) {
     test_object1* obj2 = read_master_to_slave();
     EXPECT_EQ(obj2, nullptr);
 }
+
+TEST_F(Transport, sends_objects_unchanged_from_the_space_reserved_around_them) {
+    update_transport();
+    EXPECT_CALL(*this, signal_data_written()).Times(2 * NUM_SLAVES);
+    EXPECT_CALL(*this, router_send_frame(_)).Times(2 * NUM_SLAVES);
+    int round;
+    for (round = 0; round < 2; round++) {
+        uint8_t i;
+        for (i = 0; i < NUM_SLAVES; i++) {
+            test_object1* obj = begin_write_master_to_single_slave(i);
+            obj->test = 0x01020304 * (i + 1) + round;
+            end_write_master_to_single_slave(i);
+        }
+        sent_frames.clear();
+        update_transport();
+        ASSERT_EQ(sent_frames.size(), NUM_SLAVES);
+        for (i = 0; i < NUM_SLAVES; i++) {
+            uint32_t value = 0x01020304 * (i + 1) + round;
+            std::vector<uint8_t> expected((uint8_t*)&value, (uint8_t*)&value + 4);
+            // The id of master_to_single_slave
+            expected.push_back(1);
+            EXPECT_EQ(sent_frames[i], expected) << "slave " << (int)i << ", round " << round;
+        }
+    }
+}
+
+TEST_F(Transport, sends_only_the_changes_of_delta_objects) {
+    EXPECT_CALL(*this, signal_data_written()).Times(3);
+    EXPECT_CALL(*this, router_send_frame(0xFF)).Times(3);
+    test_object3 leds = {};
+    std::vector<uint8_t> frame = send_leds(leds);
+    // The first frame is a keyframe, with the sequence number, encoding and id
+    EXPECT_EQ(frame.size(), sizeof(leds) + 3);
+    transport_recv_frame(0, frame.data(), frame.size());
+    test_object3* received = read_master_to_slave_delta();
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(memcmp(received, &leds, sizeof(leds)), 0);
+
+    leds.leds[17] = 0x80;
+    frame = send_leds(leds);
+    EXPECT_LE(frame.size(), 8);
+    transport_recv_frame(0, frame.data(), frame.size());
+    received = read_master_to_slave_delta();
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(memcmp(received, &leds, sizeof(leds)), 0);
+
+    // Every other led is better sent as a bitmap
+    for (int i = 0; i < sizeof(leds.leds); i += 2) {
+        leds.leds[i] = i + 1;
+    }
+    frame = send_leds(leds);
+    EXPECT_LE(frame.size(), sizeof(leds.leds) / 8 + sizeof(leds.leds) / 2 + 3);
+    transport_recv_frame(0, frame.data(), frame.size());
+    received = read_master_to_slave_delta();
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(memcmp(received, &leds, sizeof(leds)), 0);
+}
+
+TEST_F(Transport, delta_objects_stay_in_sync_over_random_changes) {
+    EXPECT_CALL(*this, signal_data_written()).Times(200);
+    EXPECT_CALL(*this, router_send_frame(0xFF)).Times(200);
+    srand(3);
+    test_object3 leds = {};
+    size_t total_size = 0;
+    int i;
+    for (i = 0; i < 200; i++) {
+        int changes = rand() % (i % 10 == 0 ? 200 : 8);
+        while (changes--) {
+            leds.leds[rand() % sizeof(leds.leds)] = rand();
+        }
+        std::vector<uint8_t> frame = send_leds(leds);
+        total_size += frame.size();
+        transport_recv_frame(0, frame.data(), frame.size());
+        test_object3* received = read_master_to_slave_delta();
+        ASSERT_NE(received, nullptr) << "frame " << i;
+        ASSERT_EQ(memcmp(received, &leds, sizeof(leds)), 0) << "frame " << i;
+    }
+    EXPECT_LT(total_size, 200 * sizeof(leds) / 4);
+}
+
+TEST_F(Transport, delta_object_resyncs_on_the_next_keyframe_after_a_lost_frame) {
+    EXPECT_CALL(*this, signal_data_written()).Times(TRANSPORT_KEYFRAME_INTERVAL + 1);
+    EXPECT_CALL(*this, router_send_frame(0xFF)).Times(TRANSPORT_KEYFRAME_INTERVAL + 1);
+    test_object3 leds = {};
+    std::vector<uint8_t> frame = send_leds(leds);
+    transport_recv_frame(0, frame.data(), frame.size());
+    EXPECT_NE(read_master_to_slave_delta(), nullptr);
+
+    leds.leds[0] = 1;
+    // Lost
+    send_leds(leds);
+    int i;
+    for (i = 2; i < TRANSPORT_KEYFRAME_INTERVAL; i++) {
+        leds.leds[i] = i;
+        frame = send_leds(leds);
+        transport_recv_frame(0, frame.data(), frame.size());
+        EXPECT_EQ(read_master_to_slave_delta(), nullptr) << "frame " << i;
+    }
+    leds.leds[i] = i;
+    frame = send_leds(leds);
+    EXPECT_EQ(frame.size(), sizeof(leds) + 3);
+    transport_recv_frame(0, frame.data(), frame.size());
+    test_object3* received = read_master_to_slave_delta();
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(memcmp(received, &leds, sizeof(leds)), 0);
+}
+
+TEST_F(Transport, delta_object_resends_a_keyframe_when_it_does_not_change) {
+    EXPECT_CALL(*this, signal_data_written()).Times(2);
+    EXPECT_CALL(*this, router_send_frame(0xFF)).Times(3);
+    test_object3 leds = {};
+    std::vector<uint8_t> frame = send_leds(leds);
+    transport_recv_frame(0, frame.data(), frame.size());
+    EXPECT_NE(read_master_to_slave_delta(), nullptr);
+
+    leds.leds[7] = 7;
+    // Lost, and nothing changes after it
+    time_ms = 10;
+    send_leds(leds);
+    sent_frames.clear();
+    time_ms = TRANSPORT_KEYFRAME_PERIOD - 1;
+    update_transport();
+    EXPECT_EQ(sent_frames.size(), 0);
+
+    time_ms = TRANSPORT_KEYFRAME_PERIOD;
+    update_transport();
+    ASSERT_EQ(sent_frames.size(), 1);
+    frame = sent_frames.back();
+    EXPECT_EQ(frame.size(), sizeof(leds) + 3);
+    transport_recv_frame(0, frame.data(), frame.size());
+    test_object3* received = read_master_to_slave_delta();
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(memcmp(received, &leds, sizeof(leds)), 0);
+
+    // And not again until the period has passed from that one
+    sent_frames.clear();
+    time_ms = 2 * TRANSPORT_KEYFRAME_PERIOD - 1;
+    update_transport();
+    EXPECT_EQ(sent_frames.size(), 0);
+}
+
+TEST_F(Transport, delta_object_ignores_changes_until_the_first_keyframe) {
+    EXPECT_CALL(*this, signal_data_written()).Times(2);
+    EXPECT_CALL(*this, router_send_frame(0xFF)).Times(2);
+    test_object3 leds = {};
+    // Lost, for example while the slave was not connected yet
+    send_leds(leds);
+    leds.leds[5] = 5;
+    std::vector<uint8_t> frame = send_leds(leds);
+    transport_recv_frame(0, frame.data(), frame.size());
+    EXPECT_EQ(read_master_to_slave_delta(), nullptr);
+}
+
+TEST_F(Transport, delta_object_ignores_corrupt_deltas) {
+    EXPECT_CALL(*this, signal_data_written()).Times(3);
+    EXPECT_CALL(*this, router_send_frame(0xFF)).Times(3);
+    test_object3 leds = {};
+    std::vector<uint8_t> frame = send_leds(leds);
+    transport_recv_frame(0, frame.data(), frame.size());
+    EXPECT_NE(read_master_to_slave_delta(), nullptr);
+
+    leds.leds[199] = 1;
+    frame = send_leds(leds);
+    // The change is now past the end of the object
+    frame[0] = 250;
+    transport_recv_frame(0, frame.data(), frame.size());
+    EXPECT_EQ(read_master_to_slave_delta(), nullptr);
+
+    leds.leds[198] = 1;
+    frame = send_leds(leds);
+    transport_recv_frame(0, frame.data(), frame.size());
+    EXPECT_EQ(read_master_to_slave_delta(), nullptr);
+}
+
+TEST_F(Transport, delta_objects_from_slaves_are_tracked_separately) {
+    EXPECT_CALL(*this, signal_data_written()).Times(4);
+    EXPECT_CALL(*this, router_send_frame(0)).Times(4);
+    test_object3 leds = {};
+    leds.leds[3] = 3;
+    std::vector<uint8_t> frames[4];
+    int i;
+    for (i = 0; i < 4; i++) {
+        leds.leds[i * 10] = i + 1;
+        *begin_write_slave_to_master_delta() = leds;
+        end_write_slave_to_master_delta();
+        sent_frames.clear();
+        update_transport();
+        ASSERT_EQ(sent_frames.size(), 1);
+        frames[i] = sent_frames.back();
+    }
+    // The first slave gets everything, the second misses the keyframe
+    for (i = 0; i < 4; i++) {
+        transport_recv_frame(1, frames[i].data(), frames[i].size());
+        if (i > 0) {
+            transport_recv_frame(2, frames[i].data(), frames[i].size());
+        }
+    }
+    test_object3* received = read_slave_to_master_delta(0);
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(memcmp(received, &leds, sizeof(leds)), 0);
+    EXPECT_EQ(read_slave_to_master_delta(1), nullptr);
+}
+
+TEST_F(Transport, odd_sized_objects_keep_the_buffers_aligned) {
+    for (uint16_t size : {1, 3, 5, 201}) {
+        EXPECT_EQ(REMOTE_OBJECT_SIZE(size) % 4, 0) << size;
+        EXPECT_EQ(LOCAL_OBJECT_SIZE(size) % 4, 0) << size;
+        EXPECT_EQ(DELTA_REMOTE_SIZE(size) % 4, 0) << size;
+        EXPECT_EQ(DELTA_LOCAL_SIZE(size) % 4, 0) << size;
+    }
+}
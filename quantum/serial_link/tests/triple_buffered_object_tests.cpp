@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "gtest/gtest.h"
+#include <pthread.h>
 extern "C" {
 #include "serial_link/protocol/triple_buffered_object.h"
 }
@@ -82,3 +83,51 @@ TEST_F(TripleBufferedObject, performs_two_writes_in_the_middle_of_read) {
     EXPECT_EQ(*triple_buffer_read(&test_object), 3);
     EXPECT_EQ(triple_buffer_read(&test_object), nullptr);
 }
+
+struct stress_data {
+    uint32_t values[16];
+};
+
+struct stress_object {
+    uint8_t state;
+    stress_data buffer[3];
+};
+
+stress_object stress_object;
+
+static const uint32_t num_stress_writes = 200000;
+
+static void* stress_writer(void* arg) {
+    (void)arg;
+    uint32_t i;
+    for (i = 1; i <= num_stress_writes; i++) {
+        stress_data* data = triple_buffer_begin_write(&stress_object);
+        for (uint32_t& value : data->values) {
+            value = i;
+        }
+        triple_buffer_end_write(&stress_object);
+    }
+    return nullptr;
+}
+
+TEST_F(TripleBufferedObject, reader_never_sees_torn_writes_from_another_thread) {
+    triple_buffer_init((triple_buffer_object_t*)&stress_object);
+    pthread_t writer;
+    ASSERT_EQ(pthread_create(&writer, nullptr, stress_writer, nullptr), 0);
+    uint32_t last = 0;
+    uint32_t num_reads = 0;
+    while (last != num_stress_writes) {
+        stress_data* data = triple_buffer_read(&stress_object);
+        if (data) {
+            uint32_t first = data->values[0];
+            for (uint32_t value : data->values) {
+                ASSERT_EQ(value, first) << "after " << num_reads << " reads";
+            }
+            ASSERT_GT(first, last);
+            last = first;
+            num_reads++;
+        }
+    }
+    pthread_join(writer, nullptr);
+    EXPECT_EQ(triple_buffer_read(&stress_object), nullptr);
+}
@@ -0,0 +1,85 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Host tool run by keymap_action_table.mk. Reads the raw little endian
+ * contents of the keymaps array from stdin, and writes a C file with the
+ * keymap_actions table to stdout.
+ *
+ * The keycodes are decoded with the firmware's own action_for_keycode().
+ * Keycodes whose action changes with the keymap config (the magic swaps) or
+ * with fn_actions get KEYMAP_ACTION_DECODE, so that the firmware decodes
+ * them at runtime instead.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "keymap.h"
+
+keymap_config_t keymap_config;
+
+uint8_t eeconfig_read_keymap(void) {
+    return keymap_config.raw;
+}
+
+/* fn_actions is only known to the firmware */
+static uint16_t fn_action_salt;
+
+uint16_t keymap_function_id_to_action(uint16_t function_id) {
+    return function_id ^ fn_action_salt;
+}
+
+static uint16_t translate(uint16_t keycode) {
+    uint16_t action = KEYMAP_ACTION_DECODE;
+    for (uint16_t config = 0; config <= UINT8_MAX; config++) {
+        for (uint8_t salt = 0; salt < 2; salt++) {
+            keymap_config.raw = config;
+            fn_action_salt = salt ? 0xFFFF : 0;
+            uint16_t code = action_for_keycode(keycode).code;
+            if (config == 0 && salt == 0) {
+                action = code;
+            } else if (code != action) {
+                return KEYMAP_ACTION_DECODE;
+            }
+        }
+    }
+    return action;
+}
+
+int main(void) {
+    unsigned count = 0;
+    int lo, hi;
+
+    printf("/* Generated by quantum/tools/keymap_action_table.c, do not edit */\n");
+    printf("#include <stdint.h>\n");
+    printf("#include \"progmem.h\"\n\n");
+    printf("const uint16_t PROGMEM keymap_actions[] = {");
+    while ((lo = getchar()) != EOF) {
+        if ((hi = getchar()) == EOF) {
+            fprintf(stderr, "keymap_action_table: odd keymaps size\n");
+            return EXIT_FAILURE;
+        }
+        uint16_t keycode = (uint16_t)(lo | (hi << 8));
+        printf("%s0x%04X,", (count % 8) ? " " : "\n    ", translate(keycode));
+        count++;
+    }
+    printf("\n};\n");
+
+    if (count == 0) {
+        fprintf(stderr, "keymap_action_table: no keymaps found\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_AUTO_SHIFT_CONFIG_H_
+#define TESTS_AUTO_SHIFT_CONFIG_H_
+
+#define MATRIX_ROWS 3
+#define MATRIX_COLS 10
+
+#define AUTO_SHIFT_TIMEOUT 175
+#define AUTO_SHIFT_TIMEOUT_PER_KEY
+// get_auto_shift_timeout() gives the Q key this instead
+#define Q_AUTO_SHIFT_TIMEOUT 300
+
+#endif /* TESTS_AUTO_SHIFT_CONFIG_H_ */
@@ -0,0 +1,145 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class AutoShift : public TestFixture {
+protected:
+    AutoShift() {
+        autoshift_reset_hold_times();
+    }
+
+    static keypos_t position_of(char c) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keypos_t key = {.col = col, .row = row};
+                if (char_of(keymap_key_to_keycode(0, key)) == tolower(c)) {
+                    return key;
+                }
+            }
+        }
+        ADD_FAILURE() << "no key for " << c;
+        return (keypos_t){};
+    }
+
+    struct event_t {
+        unsigned time;
+        char key;
+        bool pressed;
+    };
+
+    // Runs a scan every millisecond, with each event on its time
+    void play(std::vector<event_t> events) {
+        std::stable_sort(events.begin(), events.end(), [](const event_t& a, const event_t& b) {
+            return a.time < b.time;
+        });
+        unsigned now = 0;
+        for (const event_t& event : events) {
+            for (; now < event.time; now++) {
+                run_one_scan_loop();
+            }
+            keypos_t key = position_of(event.key);
+            if (event.pressed) {
+                press_key(key.col, key.row);
+            } else {
+                release_key(key.col, key.row);
+            }
+        }
+        idle_for(AUTO_SHIFT_TIMEOUT * 2);
+    }
+
+    // Typed at the speed, with every key held a little longer than the
+    // time to the next one, and the capitals held past the timeout
+    void type(const std::string& text, unsigned wpm, unsigned capital_hold) {
+        unsigned interval = 60000 / (wpm * 5);
+        std::vector<event_t> events;
+        for (size_t i = 0; i < text.size(); i++) {
+            unsigned hold = std::min(interval + interval / 4, 140u);
+            if (isupper(text[i])) {
+                hold = capital_hold;
+            } else if (i + 1 < text.size() && text[i + 1] == text[i]) {
+                // The same key can't be pressed again before it is released
+                hold = interval * 3 / 4;
+            }
+            events.push_back({(unsigned)i * interval, text[i], true});
+            events.push_back({(unsigned)i * interval + hold, text[i], false});
+        }
+        play(events);
+    }
+};
+
+TEST_F(AutoShift, RolloverKeepsEachKeysOwnDecision) {
+    TestDriver driver;
+    record(driver);
+    // B is pressed and released while A is held past the timeout
+    play({{0, 'a', true}, {60, 'b', true}, {140, 'b', false}, {260, 'a', false}});
+    EXPECT_EQ(typed(), "Ab");
+}
+
+TEST_F(AutoShift, KeysAreSentInTheOrderTheyWerePressed) {
+    TestDriver driver;
+    record(driver);
+    keypos_t a = position_of('a');
+    keypos_t b = position_of('b');
+    press_key(a.col, a.row);
+    idle_for(20);
+    press_key(b.col, b.row);
+    idle_for(20);
+    release_key(b.col, b.row);
+    idle_for(20);
+    // B is decided, but waits for A
+    EXPECT_EQ(typed(), "");
+    release_key(a.col, a.row);
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "ab");
+}
+
+TEST_F(AutoShift, KeyHeldPastItsTimeoutIsSentBeforeItsRelease) {
+    TestDriver driver;
+    record(driver);
+    keypos_t key = position_of('a');
+    press_key(key.col, key.row);
+    idle_for(AUTO_SHIFT_TIMEOUT + 2);
+    EXPECT_EQ(typed(), "A");
+    release_key(key.col, key.row);
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "A");
+    EXPECT_EQ(autoshift_average_hold_time(), AUTO_SHIFT_TIMEOUT + 2);
+}
+
+TEST_F(AutoShift, EachKeyHasItsOwnTimeout) {
+    TestDriver driver;
+    record(driver);
+    play({{0, 'q', true}, {200, 'q', false}, {300, 'a', true}, {500, 'a', false}});
+    EXPECT_EQ(typed(), "qA");
+}
+
+TEST_F(AutoShift, RollingSentencesAtRealisticSpeeds) {
+    const std::string text = "Hello World. The quick Brown fox jumps over the lazy Dog.";
+    for (unsigned wpm : {60, 90, 120, 150}) {
+        TestDriver driver;
+        record(driver);
+        reports.clear();
+        autoshift_reset_hold_times();
+        type(text, wpm, AUTO_SHIFT_TIMEOUT + 60);
+        EXPECT_EQ(typed(), text) << wpm << " WPM";
+        EXPECT_LT(autoshift_average_tap_time(), autoshift_average_hold_time()) << wpm << " WPM";
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+}
@@ -95,3 +95,71 @@ TEST_F(Tapping, ANewTapWithinTappingTermIsBuggy) {
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).Times(1);
     idle_for(TAPPING_TERM);
 }
+
+TEST_F(Tapping, TypingFastWhileHoldingA_SHFT_T_KeyDoesNotDropKeys) {
+    TestDriver driver;
+    InSequence s;
+    const uint16_t overflows = action_tapping_overflows();
+    // All typed well inside the tapping term, at two scans per tap
+    const uint8_t taps = 50;
+    static_assert(2 * taps + 1 < TAPPING_TERM, "the taps must fit in the tapping term");
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    // Alternate A and C, more events than the waiting buffer can hold
+    for (uint8_t i = 0; i < taps; i++) {
+        uint8_t row = i % 2 ? 3 : 0;
+        uint8_t key = i % 2 ? KC_C : KC_A;
+        // The buffer overflows when this key is released, which settles shift as held
+        if (i == (WAITING_BUFFER_SIZE - 1) / 2) {
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+            for (uint8_t j = 0; j < i; j++) {
+                EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, j % 2 ? KC_C : KC_A)));
+                EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+            }
+        }
+        press_key(0, row);
+        if (i >= (WAITING_BUFFER_SIZE - 1) / 2) {
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, key)));
+        }
+        run_one_scan_loop();
+        release_key(0, row);
+        if (i >= (WAITING_BUFFER_SIZE - 1) / 2) {
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+        }
+        run_one_scan_loop();
+    }
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_GT(action_tapping_overflows(), overflows);
+}
+
+TEST_F(Tapping, ReleasingA_SHFT_T_KeyInsideTheTermAfterAnOverflowDoesNotTapIt) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    // Until the buffer overflows, on the release of the last A
+    const uint8_t taps = (WAITING_BUFFER_SIZE - 1) / 2 + 1;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    for (uint8_t i = 0; i < taps; i++) {
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    }
+    for (uint8_t i = 0; i < taps; i++) {
+        press_key(0, 0);
+        run_one_scan_loop();
+        release_key(0, 0);
+        run_one_scan_loop();
+    }
+    // Shift was settled as held, so releasing it inside the term is no P
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(7, 0);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM);
+}
@@ -0,0 +1,35 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// Column 0 of every row is a normal key on the base layer, the rest is KC_NO
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A}, {KC_B}, {KC_C}, {KC_D}, {KC_E}, {KC_F}, {KC_G}, {KC_H},
+        {KC_I}, {KC_J}, {KC_K}, {KC_L}, {KC_M}, {KC_N}, {KC_O}, {KC_P},
+        {KC_Q}, {KC_R}, {KC_S}, {KC_T}, {KC_U}, {KC_V}, {KC_W}, {KC_X},
+        {KC_Y}, {KC_Z}, {KC_1}, {KC_2}, {KC_3}, {KC_4}, {KC_5}, {KC_6},
+    },
+    // Transparent, so that resolving a key walks every active layer
+    [1 ... 30] = {
+        [0 ... MATRIX_ROWS - 1] = {[0 ... MATRIX_COLS - 1] = KC_TRNS},
+    },
+    [31] = {
+        [0 ... MATRIX_ROWS - 2] = {[0 ... MATRIX_COLS - 1] = KC_TRNS},
+        {KC_ESC, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS},
+    },
+};
@@ -0,0 +1,110 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <chrono>
+#include <cstdio>
+
+class LayerCache : public TestFixture {
+protected:
+    ~LayerCache() {
+        default_layer_state = 0;
+        layer_state = 0;
+    }
+};
+
+static const unsigned iterations = 100;
+
+static void activate_layers(uint8_t count) {
+    default_layer_state = 1;
+    layer_state = count < 32 ? (1UL << count) - 1 : 0xFFFFFFFF;
+}
+
+// Returns the average cost of one lookup in nanoseconds
+static double time_lookups(bool cached) {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                if (!cached) {
+                    layer_action_cache_clear();
+                }
+                layer_switch_get_action((keypos_t){.col = col, .row = row});
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (iterations * MATRIX_ROWS * MATRIX_COLS);
+}
+
+// The top active layer that isn't transparent for the key, straight from the
+// keymap
+static uint8_t expected_layer(keypos_t key) {
+    uint32_t layers = layer_state | default_layer_state;
+    for (int8_t layer = 31; layer > 0; layer--) {
+        if ((layers & (1UL << layer)) && action_for_key(layer, key).code != ACTION_TRANSPARENT) {
+            return layer;
+        }
+    }
+    return 0;
+}
+
+// Both the lookup that fills the cache and the one that hits it
+static void expect_keymap_actions(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            keypos_t key = {.col = col, .row = row};
+            uint8_t layer = expected_layer(key);
+            uint16_t code = action_for_key(layer, key).code;
+            layer_action_cache_clear();
+            for (uint8_t lookup = 0; lookup < 2; lookup++) {
+                EXPECT_EQ(layer_switch_get_layer(key), layer) << "row " << (int)row << " col " << (int)col;
+                EXPECT_EQ(layer_switch_get_action(key).code, code) << "row " << (int)row << " col " << (int)col;
+            }
+        }
+    }
+}
+
+TEST_F(LayerCache, CachedActionsMatchTheKeymap) {
+    const uint8_t layer_counts[] = {1, 4, 31, 32};
+    for (uint8_t layers : layer_counts) {
+        activate_layers(layers);
+        expect_keymap_actions();
+    }
+}
+
+TEST_F(LayerCache, LayerChangesAreNoticed) {
+    keypos_t key = {.col = 0, .row = 31};
+    activate_layers(31);
+    EXPECT_EQ(layer_switch_get_layer(key), 0);
+    EXPECT_EQ(layer_switch_get_action(key).code, ACTION_KEY(KC_6));
+    activate_layers(32);
+    EXPECT_EQ(layer_switch_get_layer(key), 31);
+    EXPECT_EQ(layer_switch_get_action(key).code, ACTION_KEY(KC_ESC));
+    activate_layers(31);
+    EXPECT_EQ(layer_switch_get_layer(key), 0);
+}
+
+TEST_F(LayerCache, ResolutionCost) {
+    const uint8_t layer_counts[] = {4, 16, 32};
+    for (uint8_t layers : layer_counts) {
+        activate_layers(layers);
+        double uncached = time_lookups(false);
+        double cached = time_lookups(true);
+        expect_keymap_actions();
+        printf("%2u active layers: %.1f ns uncached, %.1f ns cached\n", layers, uncached, cached);
+    }
+}
@@ -0,0 +1,76 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <chrono>
+#include <cstdio>
+
+using testing::_;
+using testing::AnyNumber;
+
+class MatrixScan : public TestFixture {};
+
+static const unsigned iterations = 100;
+
+// Returns the average cost of a keyboard_task call in nanoseconds
+template<typename F>
+static double time_scans(unsigned scans, F body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / scans;
+}
+
+TEST_F(MatrixScan, IdleScanDoesNotSendAnything) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    const unsigned scans = 10000;
+    double ns = time_scans(scans, [&]() {
+        for (unsigned i = 0; i < scans; i++) {
+            keyboard_task();
+        }
+    });
+    printf("idle scan: %.1f ns/scan\n", ns);
+}
+
+TEST_F(MatrixScan, EveryChangedRowIsProcessedOnce) {
+    const uint8_t row_counts[] = {1, 4, 8, 16, 32};
+    for (uint8_t rows : row_counts) {
+        TestDriver driver;
+        // Every press and release sends exactly one report, in one scan each,
+        // except for the keys that don't fit in the report
+        unsigned reported = rows < KEYBOARD_REPORT_KEYS ? rows : KEYBOARD_REPORT_KEYS;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2 * reported * iterations);
+        double ns = time_scans(2 * rows * iterations, [&]() {
+            for (unsigned i = 0; i < iterations; i++) {
+                for (uint8_t r = 0; r < rows; r++) {
+                    press_key(0, r);
+                }
+                for (uint8_t r = 0; r < rows; r++) {
+                    keyboard_task();
+                }
+                for (uint8_t r = 0; r < rows; r++) {
+                    release_key(0, r);
+                }
+                for (uint8_t r = 0; r < rows; r++) {
+                    keyboard_task();
+                }
+            }
+        });
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        printf("%2u changed rows: %.1f ns/scan\n", rows, ns);
+    }
+}
@@ -0,0 +1,39 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_COMBO_INDEX_CONFIG_H_
+#define TESTS_COMBO_INDEX_CONFIG_H_
+
+#define MATRIX_ROWS 3
+#define MATRIX_COLS 14
+
+#define TAPPING_TERM 200
+#define COMBO_COUNT 160
+#define COMBO_MAX_LENGTH 40
+// Room for 160 pairs, but not for 160 triples
+#define COMBO_INDEX_SIZE 330
+
+// The tests count the flash reads, the combo keys are only read from there
+#include <stdint.h>
+#include "progmem.h"
+#ifdef __cplusplus
+extern "C"
+#endif
+uint16_t counted_pgm_read_word(const void *p);
+#undef pgm_read_word
+#define pgm_read_word(p) counted_pgm_read_word(p)
+
+#endif /* TESTS_COMBO_INDEX_CONFIG_H_ */
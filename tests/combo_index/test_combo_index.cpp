@@ -0,0 +1,203 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "recorded_combos.h"
+#include <cstring>
+
+using testing::_;
+using testing::AnyNumber;
+
+static uint16_t combo_keys[COMBO_COUNT][COMBO_MAX_LENGTH + 2];
+static const uint16_t no_keys[] = {COMBO_END};
+
+class ComboIndex : public TestFixture {
+protected:
+    ComboIndex() {
+        last_combo_index = -1;
+        last_combo_pressed = false;
+    }
+
+    ~ComboIndex() {
+        memset(key_combos, 0, sizeof(key_combos));
+        for (uint8_t i = 0; i < COMBO_COUNT; i++) {
+            key_combos[i].keys = no_keys;
+        }
+        combo_index_build();
+    }
+
+    // Every combination of `length` of the first 26 keys, in order, as far as they go
+    void use_combinations(uint8_t length) {
+        uint8_t pick[COMBO_MAX_LENGTH];
+        for (uint8_t i = 0; i < length; i++) {
+            pick[i] = i;
+        }
+        memset(key_combos, 0, sizeof(key_combos));
+        for (uint8_t i = 0; i < COMBO_COUNT; i++) {
+            for (uint8_t k = 0; k < length; k++) {
+                combo_keys[i][k] = keycode_of(pick[k]);
+            }
+            combo_keys[i][length] = COMBO_END;
+            key_combos[i].keys = combo_keys[i];
+            int8_t k = length - 1;
+            while (k >= 0 && pick[k] == 26 - length + k) {
+                k--;
+            }
+            pick[k]++;
+            for (k++; k < length; k++) {
+                pick[k] = pick[k - 1] + 1;
+            }
+        }
+        combo_index_build();
+    }
+
+    // Combo 0 has the first `length` keys, the rest none
+    void use_one_combo(uint8_t length) {
+        memset(key_combos, 0, sizeof(key_combos));
+        for (uint8_t k = 0; k < length; k++) {
+            combo_keys[0][k] = keycode_of(k);
+        }
+        combo_keys[0][length] = COMBO_END;
+        key_combos[0].keys = combo_keys[0];
+        for (uint8_t i = 1; i < COMBO_COUNT; i++) {
+            key_combos[i].keys = no_keys;
+        }
+        combo_index_build();
+    }
+
+    static keypos_t position_of(uint8_t key) {
+        return (keypos_t){.col = (uint8_t)(key % MATRIX_COLS), .row = (uint8_t)(key / MATRIX_COLS)};
+    }
+
+    static uint16_t keycode_of(uint8_t key) {
+        return keymap_key_to_keycode(0, position_of(key));
+    }
+
+    void press(uint8_t key) {
+        press_key(key % MATRIX_COLS, key / MATRIX_COLS);
+        run_one_scan_loop();
+    }
+
+    void release(uint8_t key) {
+        release_key(key % MATRIX_COLS, key / MATRIX_COLS);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(ComboIndex, PairFiresItsOwnCombo) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    use_combinations(2);
+    // The pairs with A come first, B's start at 25
+    press(1);
+    press(3);
+    EXPECT_EQ(last_combo_index, 26);
+    EXPECT_TRUE(last_combo_pressed);
+    release(1);
+    EXPECT_FALSE(last_combo_pressed);
+    release(3);
+    idle_for(COMBO_TERM + 1);
+}
+
+TEST_F(ComboIndex, CombosThatDontFitInTheIndexStillFire) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    use_combinations(3);
+    // The triples with A and B come first, then A, C and D, which is indexed
+    press(0);
+    press(2);
+    press(3);
+    EXPECT_EQ(last_combo_index, 24);
+    EXPECT_TRUE(last_combo_pressed);
+    release(0);
+    release(2);
+    release(3);
+    idle_for(COMBO_TERM + 1);
+
+    // The first 110 triples fill the index, A, G and H comes after them
+    press(0);
+    press(6);
+    press(7);
+    EXPECT_EQ(last_combo_index, 110);
+    EXPECT_TRUE(last_combo_pressed);
+    release(0);
+    release(6);
+    release(7);
+    idle_for(COMBO_TERM + 1);
+}
+
+TEST_F(ComboIndex, CombosLongerThanAWordFire) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    use_one_combo(COMBO_MAX_LENGTH);
+    for (uint8_t key = 0; key < COMBO_MAX_LENGTH; key++) {
+        EXPECT_EQ(last_combo_index, -1);
+        press(key);
+    }
+    EXPECT_EQ(last_combo_index, 0);
+    EXPECT_TRUE(last_combo_pressed);
+    release(0);
+    EXPECT_FALSE(last_combo_pressed);
+    for (uint8_t key = 1; key < COMBO_MAX_LENGTH; key++) {
+        release(key);
+    }
+}
+
+TEST_F(ComboIndex, CombosLongerThanTheMaximumAreIgnored) {
+    TestDriver driver;
+    use_one_combo(COMBO_MAX_LENGTH + 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    press(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release(0);
+    EXPECT_EQ(last_combo_index, -1);
+}
+
+// The flash reads of one press and release of every key that isn't part of
+// a combo
+static uint32_t reads_of_other_keys() {
+    keyrecord_t record = {};
+    pgm_read_word_count = 0;
+    for (uint16_t keycode = KC_1; keycode <= KC_0; keycode++) {
+        record.event.pressed = true;
+        process_combo(keycode, &record);
+        record.event.pressed = false;
+        process_combo(keycode, &record);
+    }
+    return pgm_read_word_count;
+}
+
+static const uint32_t other_key_events = 2 * (KC_0 - KC_1 + 1);
+
+// The reads of a binary search of the index and the check after it
+static uint32_t search_reads() {
+    uint32_t steps = 0;
+    while ((1UL << steps) <= COMBO_INDEX_SIZE) {
+        steps++;
+    }
+    return steps + 1;
+}
+
+TEST_F(ComboIndex, KeysOutsideTheCombosOnlySearchTheIndex) {
+    use_combinations(2);
+    EXPECT_LE(reads_of_other_keys(), other_key_events * search_reads());
+}
+
+TEST_F(ComboIndex, OnlyTheCombosThatDontFitAreScanned) {
+    use_combinations(3);
+    const uint32_t unindexed = COMBO_COUNT - COMBO_INDEX_SIZE / 3;
+    EXPECT_LE(reads_of_other_keys(), other_key_events * (search_reads() + unindexed * 3));
+}
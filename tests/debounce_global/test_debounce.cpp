@@ -0,0 +1,77 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "debounce.h"
+
+using testing::_;
+using testing::InSequence;
+
+class DebounceGlobal : public TestFixture {
+protected:
+    // Toggles the key every scan, the last toggle leaves it pressed
+    void bounce_press(uint8_t col, uint8_t row, unsigned bounces) {
+        for (unsigned i = 0; i < bounces; i++) {
+            press_key(col, row);
+            run_one_scan_loop();
+            release_key(col, row);
+            run_one_scan_loop();
+        }
+        press_key(col, row);
+    }
+};
+
+TEST_F(DebounceGlobal, PressIsDelayedByTheDebouncingDelay) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(DEBOUNCING_DELAY + 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(DEBOUNCING_DELAY + 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(DebounceGlobal, BouncingPressIsReportedOnceAfterItSettles) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    bounce_press(0, 0, 3);
+    idle_for(DEBOUNCING_DELAY + 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+}
+
+TEST_F(DebounceGlobal, BouncingKeyDelaysKeysOnOtherRows) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    // The chatter on the second row keeps restarting the timer for KC_A too
+    bounce_press(0, 1, DEBOUNCING_DELAY);
+    idle_for(DEBOUNCING_DELAY + 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_C)));
+    idle_for(2);
+}
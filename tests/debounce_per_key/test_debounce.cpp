@@ -0,0 +1,102 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "debounce.h"
+
+using testing::_;
+using testing::InSequence;
+
+class DebouncePerKey : public TestFixture {
+protected:
+    // Toggles the key every scan, the last toggle leaves it released
+    void bounce_release(uint8_t col, uint8_t row, unsigned bounces) {
+        for (unsigned i = 0; i < bounces; i++) {
+            release_key(col, row);
+            run_one_scan_loop();
+            press_key(col, row);
+            run_one_scan_loop();
+        }
+        release_key(col, row);
+    }
+};
+
+TEST_F(DebouncePerKey, PressIsReportedImmediately) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+}
+
+TEST_F(DebouncePerKey, ReleaseIsDelayedByTheDebouncingDelay) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(DEBOUNCING_DELAY);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(DebouncePerKey, BouncingPressIsReportedOnce) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    // The contact opening again doesn't last long enough to count as a release
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    bounce_release(0, 0, 3);
+    press_key(0, 0);
+    idle_for(DEBOUNCING_DELAY * 2);
+}
+
+TEST_F(DebouncePerKey, BouncingReleaseIsReportedOnceAfterItSettles) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    bounce_release(0, 0, 3);
+    idle_for(DEBOUNCING_DELAY);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(DebouncePerKey, BouncingKeyDoesNotDelayOtherKeys) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    run_one_scan_loop();
+    release_key(1, 0);
+    run_one_scan_loop();
+    press_key(1, 0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_A)));
+    run_one_scan_loop();
+}
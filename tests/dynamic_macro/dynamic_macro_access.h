@@ -0,0 +1,38 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "action.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// From dynamic_macro.h, which the keymap includes
+uint8_t dynamic_macro_encode_event(uint8_t *buffer, const keyrecord_t *record, uint16_t delay);
+uint8_t dynamic_macro_decode_event(const uint8_t *buffer, keyrecord_t *record, uint16_t *delay);
+void dynamic_macro_load(void);
+
+// Keymap helpers
+uint16_t dynamic_macro_capacity(void);
+uint16_t dynamic_macro_event_count(uint8_t slot);
+void dynamic_macro_forget(void);
+
+#ifdef __cplusplus
+}
+#endif
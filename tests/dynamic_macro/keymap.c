@@ -0,0 +1,61 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+enum custom_keycodes {
+    DYNAMIC_MACRO_RANGE = SAFE_RANGE,
+};
+
+#include "dynamic_macro.h"
+#include "dynamic_macro_access.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {DYN_REC_START1, DYN_REC_START2, DYN_REC_START(3), DYN_REC_STOP, DYN_MACRO_PLAY1, DYN_MACRO_PLAY2, DYN_MACRO_PLAY(3), KC_A, KC_B, KC_C},
+    },
+};
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (!process_record_dynamic_macro(keycode, record)) {
+        return false;
+    }
+    return true;
+}
+
+uint16_t dynamic_macro_capacity(void) {
+    return DYNAMIC_MACRO_BYTES;
+}
+
+uint16_t dynamic_macro_event_count(uint8_t slot) {
+    uint16_t count = 0;
+    uint16_t offset = dynamic_macro_slots[slot - 1].offset;
+    uint16_t end = offset + dynamic_macro_slots[slot - 1].length;
+    while (offset < end) {
+        keyrecord_t record;
+        uint16_t delay;
+        offset += dynamic_macro_decode_event(&dynamic_macro_buffer[offset], &record, &delay);
+        count++;
+    }
+    return count;
+}
+
+// As after a power cycle
+void dynamic_macro_forget(void) {
+    memset(dynamic_macro_buffer, 0, sizeof(dynamic_macro_buffer));
+    memset(dynamic_macro_slots, 0, sizeof(dynamic_macro_slots));
+    dynamic_macro_used = 0;
+}
@@ -0,0 +1,185 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "dynamic_macro_access.h"
+#include <string>
+#include <vector>
+
+enum {
+    REC1, REC2, REC3, STOP, PLAY1, PLAY2, PLAY3, KEY_A, KEY_B, KEY_C
+};
+
+class DynamicMacro : public TestFixture {
+protected:
+    void tap(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+
+    void record_macro(uint8_t rec, const std::string &keys) {
+        tap(rec);
+        for (char c : keys) {
+            tap(KEY_A + c - 'a');
+        }
+        tap(STOP);
+    }
+
+    // Plays the macro to the end, returns the keys it pressed
+    std::string play_macro(uint8_t play) {
+        tap(play);
+        reports.clear();
+        idle_for(100);
+        std::string typed;
+        for (report_keyboard_t& report : reports) {
+            if (report.keys[0]) {
+                typed += 'a' + report.keys[0] - KC_A;
+            }
+        }
+        return typed;
+    }
+};
+
+TEST_F(DynamicMacro, EventsRoundTrip) {
+    const uint16_t delays[] = {0, 1, 127, 128, 16382, 16383};
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            for (uint16_t delay : delays) {
+                keyrecord_t record = {};
+                record.event.key = (keypos_t){.col = col, .row = row};
+                record.event.pressed = (row + col) % 2;
+                record.tap.count = (col + delay) % 16;
+                record.tap.interrupted = row % 2;
+                uint8_t buffer[8];
+                uint8_t size = dynamic_macro_encode_event(buffer, &record, delay);
+                keyrecord_t decoded = {};
+                uint16_t decoded_delay;
+                EXPECT_EQ(dynamic_macro_decode_event(buffer, &decoded, &decoded_delay), size);
+                EXPECT_EQ(decoded.event.key.row, row);
+                EXPECT_EQ(decoded.event.key.col, col);
+                EXPECT_EQ(decoded.event.pressed, record.event.pressed);
+                EXPECT_EQ(decoded.tap.count, record.tap.count);
+                EXPECT_EQ(decoded.tap.interrupted, record.tap.interrupted);
+                EXPECT_EQ(decoded_delay, delay);
+                EXPECT_EQ(size, 1 + (row * MATRIX_COLS + col < 128 ? 1 : 2) + (delay < 128 ? 1 : 2));
+            }
+        }
+    }
+
+    // Longer delays are cut short
+    keyrecord_t record = {};
+    uint8_t buffer[8];
+    uint16_t delay;
+    EXPECT_EQ(dynamic_macro_encode_event(buffer, &record, 60000), 4);
+    dynamic_macro_decode_event(buffer, &record, &delay);
+    EXPECT_EQ(delay, 16383);
+}
+
+TEST_F(DynamicMacro, PlaybackRunsThroughTheScanLoop) {
+    TestDriver driver;
+    record(driver);
+    record_macro(REC1, "ab");
+    tap(PLAY1);
+    reports.clear();
+    // One event per scan
+    run_one_scan_loop();
+    ASSERT_EQ(reports.size(), 1);
+    EXPECT_TRUE(KeyboardReport(KC_A).Matches(reports[0])) << reports[0];
+    run_one_scan_loop();
+    run_one_scan_loop();
+    ASSERT_EQ(reports.size(), 3);
+    EXPECT_TRUE(KeyboardReport(KC_B).Matches(reports[2])) << reports[2];
+    idle_for(10);
+    EXPECT_TRUE(KeyboardReport().Matches(reports.back())) << reports.back();
+}
+
+TEST_F(DynamicMacro, SlotsShareTheBuffer) {
+    TestDriver driver;
+    record(driver);
+    record_macro(REC1, "abc");
+    record_macro(REC2, "ba");
+    record_macro(REC3, "c");
+    // Recording a slot again keeps the others
+    record_macro(REC1, "ca");
+    EXPECT_EQ(play_macro(PLAY1), "ca");
+    EXPECT_EQ(play_macro(PLAY2), "ba");
+    EXPECT_EQ(play_macro(PLAY3), "c");
+}
+
+TEST_F(DynamicMacro, MacrosAreKeptInEeprom) {
+    TestDriver driver;
+    record(driver);
+    record_macro(REC2, "cab");
+    dynamic_macro_forget();
+    EXPECT_EQ(play_macro(PLAY2), "");
+    dynamic_macro_load();
+    EXPECT_EQ(play_macro(PLAY2), "cab");
+}
+
+TEST_F(DynamicMacro, PackedEventsAtTypingSpeedFitInLessRam) {
+    TestDriver driver;
+    record(driver);
+    record_macro(REC2, "");
+    record_macro(REC3, "");
+    // Until the buffer is full, with the keys held and apart as long as
+    // when typing, which takes 4 bytes per event
+    tap(REC1);
+    for (int i = 0; i < DYNAMIC_MACRO_SIZE; i++) {
+        idle_for(130);
+        press_key(KEY_A, 0);
+        run_one_scan_loop();
+        idle_for(130);
+        release_key(KEY_A, 0);
+        run_one_scan_loop();
+    }
+    tap(STOP);
+    // The size of keyrecord_t on AVR
+    const size_t unpacked_ram = DYNAMIC_MACRO_SIZE * 6;
+    EXPECT_GE(dynamic_macro_event_count(1), DYNAMIC_MACRO_SIZE);
+    EXPECT_LE(dynamic_macro_capacity() * 3, unpacked_ram * 2);
+}
+
+TEST_F(DynamicMacro, RecordingStopsAtTheFirstEventThatDoesNotFit) {
+    TestDriver driver;
+    record(driver);
+    record_macro(REC2, "");
+    record_macro(REC3, "");
+    tap(REC1);
+    // Slow 7 byte taps and fast 6 byte taps leave 6 bytes
+    ASSERT_EQ(4 * 7 + 5 * 6 + 6, dynamic_macro_capacity());
+    for (int i = 0; i < 4; i++) {
+        idle_for(130);
+        tap(KEY_A);
+    }
+    for (int i = 0; i < 5; i++) {
+        tap(KEY_B);
+    }
+    press_key(KEY_C, 0);
+    run_one_scan_loop();
+    // The key on the last row takes 2 bytes, so its press doesn't fit,
+    // and the release of C, which would, isn't recorded either
+    press_key(0, MATRIX_ROWS - 1);
+    run_one_scan_loop();
+    release_key(KEY_C, 0);
+    run_one_scan_loop();
+    release_key(0, MATRIX_ROWS - 1);
+    run_one_scan_loop();
+    tap(STOP);
+    EXPECT_EQ(dynamic_macro_event_count(1), 18);
+    EXPECT_EQ(play_macro(PLAY1), "aaaabbbbb");
+}
@@ -0,0 +1,37 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_KEYEVENT_QUEUE_RECORDED_EVENTS_H_
+#define TESTS_KEYEVENT_QUEUE_RECORDED_EVENTS_H_
+
+#include "keyboard.h"
+
+#define MAX_RECORDED_EVENTS 64
+#define SLOW_KEY_TIME 20
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The events seen by process_record_user, in order
+extern keyevent_t recorded_events[MAX_RECORDED_EVENTS];
+extern uint8_t recorded_event_count;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TESTS_KEYEVENT_QUEUE_RECORDED_EVENTS_H_ */
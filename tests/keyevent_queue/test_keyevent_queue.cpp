@@ -0,0 +1,129 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "keyevent_queue.h"
+#include "recorded_events.h"
+#include "timer.h"
+
+using testing::_;
+using testing::AnyNumber;
+
+extern "C" {
+    void advance_time(uint32_t ms);
+}
+
+class KeyeventQueue : public TestFixture {
+protected:
+    KeyeventQueue() {
+        recorded_event_count = 0;
+    }
+
+    void expect_event(uint8_t index, uint8_t row, uint8_t col, bool pressed, uint16_t time) {
+        ASSERT_LT(index, recorded_event_count);
+        const keyevent_t &event = recorded_events[index];
+        EXPECT_EQ(event.key.row, row) << "event " << (int)index;
+        EXPECT_EQ(event.key.col, col) << "event " << (int)index;
+        EXPECT_EQ(event.pressed, pressed) << "event " << (int)index;
+        EXPECT_EQ(event.time, time | 1) << "event " << (int)index;
+    }
+
+    // Runs the consumer until the queue is empty
+    void drain() {
+        while (keyevent_queue_count()) {
+            keyboard_process_task();
+        }
+    }
+};
+
+static keyevent_t make_event(uint8_t col, uint16_t time) {
+    return (keyevent_t){.key = (keypos_t){.col = col, .row = 0}, .pressed = true, .time = time};
+}
+
+TEST_F(KeyeventQueue, QueueIsFirstInFirstOutAndBounded) {
+    keyevent_t event;
+    EXPECT_FALSE(keyevent_queue_pop(&event));
+    for (uint8_t i = 0; i < 3 * KEYEVENT_QUEUE_SIZE; i++) {
+        // Keep it half full, so that the indices wrap around
+        EXPECT_TRUE(keyevent_queue_push(make_event(i, i + 1)));
+        if (i >= KEYEVENT_QUEUE_SIZE / 2) {
+            ASSERT_TRUE(keyevent_queue_pop(&event));
+            EXPECT_EQ(event.key.col, i - KEYEVENT_QUEUE_SIZE / 2);
+            EXPECT_EQ(event.time, i - KEYEVENT_QUEUE_SIZE / 2 + 1);
+        }
+    }
+    while (keyevent_queue_push(make_event(0, 1))) {
+    }
+    EXPECT_EQ(keyevent_queue_count(), KEYEVENT_QUEUE_SIZE);
+    while (keyevent_queue_pop(&event)) {
+    }
+    EXPECT_EQ(keyevent_queue_count(), 0);
+}
+
+TEST_F(KeyeventQueue, SlowConsumerKeepsOrderAndScanTimes) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    uint16_t scan_time[4];
+    // The scanner keeps going while the consumer is busy
+    for (uint8_t i = 0; i < 4; i++) {
+        press_key(i + 1, 1);
+        scan_time[i] = timer_read();
+        keyboard_scan_task();
+        advance_time(7);
+    }
+    EXPECT_EQ(recorded_event_count, 0);
+    drain();
+    ASSERT_EQ(recorded_event_count, 4);
+    for (uint8_t i = 0; i < 4; i++) {
+        expect_event(i, 1, i + 1, true, scan_time[i]);
+    }
+}
+
+TEST_F(KeyeventQueue, SlowHandlerDoesNotDelayTheNextTimestamp) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(0, 0);
+    press_key(1, 0);
+    uint16_t scan_time = timer_read();
+    run_one_scan_loop();
+    run_one_scan_loop();
+    ASSERT_EQ(recorded_event_count, 2);
+    // Processed SLOW_KEY_TIME later, but stamped when it was scanned
+    expect_event(0, 0, 0, true, scan_time);
+    expect_event(1, 0, 1, true, scan_time);
+    EXPECT_GT(timer_elapsed(scan_time), SLOW_KEY_TIME);
+}
+
+TEST_F(KeyeventQueue, FullQueueDelaysEventsWithoutDroppingThem) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (uint8_t col = 1; col < MATRIX_COLS; col++) {
+        press_key(col, 1);
+    }
+    uint16_t first_scan = timer_read();
+    keyboard_scan_task();
+    EXPECT_EQ(keyevent_queue_count(), KEYEVENT_QUEUE_SIZE);
+    advance_time(3);
+    drain();
+    // The rest of the keys are picked up by the next scan
+    uint16_t second_scan = timer_read();
+    keyboard_scan_task();
+    drain();
+    ASSERT_EQ(recorded_event_count, MATRIX_COLS - 1);
+    for (uint8_t col = 1; col < MATRIX_COLS; col++) {
+        expect_event(col - 1, 1, col, true, col <= KEYEVENT_QUEUE_SIZE ? first_scan : second_scan);
+    }
+}
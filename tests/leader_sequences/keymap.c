@@ -0,0 +1,58 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+#include "recorded_sequences.h"
+#include <string.h>
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_LEAD, KC_A, KC_S, KC_D, KC_F, KC_W, KC_C, KC_Q, KC_E, KC_R, KC_T, KC_Z},
+    },
+};
+
+char last_sequence[16];
+uint16_t last_sequence_time;
+uint8_t sequence_count;
+
+static void record(const char *name) {
+    strcpy(last_sequence, name);
+    last_sequence_time = timer_read();
+    sequence_count++;
+}
+
+static void seq_a(void) { record("a"); }
+static void seq_as(void) { record("as"); }
+static void seq_asd(void) { record("asd"); }
+static void seq_f(void) { record("f"); }
+static void seq_qwerty(void) { record("qwertqwert"); }
+static void seq_wc(void) { record("wc"); }
+
+const uint16_t PROGMEM leader_a[] = {KC_A, LEADER_END};
+const uint16_t PROGMEM leader_as[] = {KC_A, KC_S, LEADER_END};
+const uint16_t PROGMEM leader_asd[] = {KC_A, KC_S, KC_D, LEADER_END};
+const uint16_t PROGMEM leader_f[] = {KC_F, LEADER_END};
+const uint16_t PROGMEM leader_qwert[] = {KC_Q, KC_W, KC_E, KC_R, KC_T, KC_Q, KC_W, KC_E, KC_R, KC_T, LEADER_END};
+const uint16_t PROGMEM leader_wc[] = {KC_W, KC_C, LEADER_END};
+
+const leader_sequence_t PROGMEM leader_sequences[] = LEADER_TABLE(
+    LEADER_SEQ(leader_a, seq_a),
+    LEADER_SEQ(leader_as, seq_as),
+    LEADER_SEQ(leader_asd, seq_asd),
+    LEADER_SEQ(leader_f, seq_f),
+    LEADER_SEQ(leader_qwert, seq_qwerty),
+    LEADER_SEQ(leader_wc, seq_wc)
+);
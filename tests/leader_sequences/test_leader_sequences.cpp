@@ -0,0 +1,122 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "recorded_sequences.h"
+#include <cstring>
+#include <string>
+
+using testing::AnyNumber;
+
+LEADER_EXTERNS();
+
+
+class LeaderSequences : public TestFixture {
+protected:
+    LeaderSequences() {
+        last_sequence[0] = 0;
+        sequence_count = 0;
+    }
+
+    void tap(uint16_t keycode) {
+        uint8_t col = 0;
+        while (keymap_key_to_keycode(0, (keypos_t){.col = col, .row = 0}) != keycode) {
+            col++;
+        }
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+
+    // Types the sequence after the leader key, returns when the last key was pressed
+    uint16_t type(const std::string &keys) {
+        tap(KC_LEAD);
+        uint16_t time = 0;
+        for (char c : keys) {
+            time = timer_read();
+            tap(KC_A + c - 'a');
+        }
+        return time;
+    }
+};
+
+TEST_F(LeaderSequences, UnambiguousSequenceRunsOnItsLastKey) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    uint16_t pressed = type("wc");
+    EXPECT_STREQ(last_sequence, "wc");
+    EXPECT_EQ(last_sequence_time, pressed);
+    EXPECT_FALSE(leading);
+}
+
+TEST_F(LeaderSequences, PrefixOfALongerSequenceWaitsForTheTimeout) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    type("as");
+    EXPECT_EQ(sequence_count, 0);
+    EXPECT_TRUE(leading);
+    idle_for(LEADER_TIMEOUT);
+    EXPECT_EQ(sequence_count, 1);
+    EXPECT_STREQ(last_sequence, "as");
+    EXPECT_FALSE(leading);
+
+    type("asd");
+    EXPECT_EQ(sequence_count, 2);
+    EXPECT_STREQ(last_sequence, "asd");
+}
+
+TEST_F(LeaderSequences, SequencesAreNotLimitedToFiveKeys) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    type("qwertqwer");
+    EXPECT_EQ(sequence_count, 0);
+    EXPECT_TRUE(leading);
+    tap(KC_T);
+    EXPECT_EQ(sequence_count, 1);
+    EXPECT_STREQ(last_sequence, "qwertqwert");
+}
+
+TEST_F(LeaderSequences, UnknownSequenceEndsRightAway) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    type("az");
+    EXPECT_FALSE(leading);
+    EXPECT_EQ(sequence_count, 0);
+
+    // The next key is typed as usual
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_F)));
+    tap(KC_F);
+}
+
+TEST_F(LeaderSequences, ResolutionLatency) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    const char *const sequences[] = {"f", "wc", "asd", "qwertqwert", "a", "as"};
+    for (const char *keys : sequences) {
+        uint8_t count = sequence_count;
+        uint16_t pressed = type(keys);
+        while (sequence_count == count) {
+            run_one_scan_loop();
+        }
+        uint16_t latency = last_sequence_time - pressed;
+        EXPECT_STREQ(last_sequence, keys);
+        // Only the prefixes of longer sequences wait
+        if (strcmp(keys, "a") && strcmp(keys, "as")) {
+            EXPECT_EQ(latency, 0) << keys;
+        }
+    }
+}
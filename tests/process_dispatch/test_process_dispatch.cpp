@@ -0,0 +1,92 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+LEADER_EXTERNS();
+
+class ProcessDispatch : public TestFixture {};
+
+static unsigned handlers_for(uint16_t keycode) {
+    return __builtin_popcount(process_dispatch_handlers(keycode));
+}
+
+TEST_F(ProcessDispatch, CountsHandlerInvocationsPerEvent) {
+    unsigned keys = 0;
+    unsigned invocations = 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            invocations += handlers_for(keymap_key_to_keycode(0, (keypos_t){.col = col, .row = row}));
+            keys++;
+        }
+    }
+    unsigned chain = process_dispatch_handler_count() * keys;
+    EXPECT_LT(invocations, chain);
+}
+
+TEST_F(ProcessDispatch, PlainKeysOnlyGoToHandlersThatWantThem) {
+    // Only combo
+    EXPECT_EQ(handlers_for(KC_ESC), 1);
+    EXPECT_EQ(handlers_for(KC_LCTL), 1);
+    // Combo and auto shift
+    EXPECT_EQ(handlers_for(KC_A), 2);
+    EXPECT_EQ(handlers_for(KC_SLSH), 2);
+}
+
+TEST_F(ProcessDispatch, FeatureKeysGoToTheirOwner) {
+    const uint16_t keycodes[] = {TD(0), KC_LEAD, UC(0x2014), KC_ASUP, KC_ASRP};
+    for (uint16_t keycode : keycodes) {
+        // Combo and the owner
+        EXPECT_EQ(handlers_for(keycode), 2) << "keycode " << keycode;
+    }
+}
+
+TEST_F(ProcessDispatch, ActiveLeaderSeesEveryKey) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(testing::AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC))).Times(0);
+    press_key(3, 3);
+    run_one_scan_loop();
+    release_key(3, 3);
+    run_one_scan_loop();
+    EXPECT_EQ(handlers_for(KC_ESC), 2);
+
+    // The leader sequence eats the key
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(leader_sequence_size, 1);
+    EXPECT_EQ(leader_sequence[0], KC_ESC);
+
+    leading = false;
+    EXPECT_EQ(handlers_for(KC_ESC), 1);
+}
+
+TEST_F(ProcessDispatch, DancingTapDanceSeesEveryKey) {
+    TestDriver driver;
+    press_key(4, 3);
+    run_one_scan_loop();
+    release_key(4, 3);
+    run_one_scan_loop();
+    EXPECT_EQ(handlers_for(KC_ESC), 2);
+
+    // The dance finishes with a single tap
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_MINS)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(testing::AtLeast(1));
+    idle_for(TAPPING_TERM + 1);
+    EXPECT_EQ(handlers_for(KC_ESC), 1);
+}
@@ -0,0 +1,98 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <string>
+
+class ReportBatch : public TestFixture {};
+
+TEST_F(ReportBatch, SendStringTypesTheSameTextWithFewerReports) {
+    TestDriver driver;
+    record(driver);
+    press_key(5, 0);
+    run_one_scan_loop();
+    release_key(5, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "Hello, World");
+    // Without batching, every character is a press and a release, and the shift one more of each
+    const std::string text = "Hello, World";
+    unsigned unbatched = 2 * text.size() + 2 * 2;
+    EXPECT_LT(driver.keyboard_reports(), unbatched);
+    EXPECT_EQ(driver.keyboard_reports(), reports.size());
+    EXPECT_TRUE(KeyboardReport().Matches(reports.back())) << reports.back();
+}
+
+TEST_F(ReportBatch, ReportsThatDontChangeAreNotSent) {
+    TestDriver driver;
+    record(driver);
+    press_key(2, 0);
+    run_one_scan_loop();
+    // The second shift doesn't change anything, and neither does releasing it after the first
+    press_key(3, 0);
+    run_one_scan_loop();
+    release_key(2, 0);
+    run_one_scan_loop();
+    release_key(3, 0);
+    run_one_scan_loop();
+    ASSERT_EQ(driver.keyboard_reports(), 2);
+    EXPECT_TRUE(KeyboardReport(KC_LSFT).Matches(reports[0])) << reports[0];
+    EXPECT_TRUE(KeyboardReport().Matches(reports[1])) << reports[1];
+}
+
+TEST_F(ReportBatch, ModifiedKeyIsSentInOneReport) {
+    TestDriver driver;
+    record(driver);
+    press_key(4, 0);
+    run_one_scan_loop();
+    ASSERT_EQ(reports.size(), 1);
+    EXPECT_TRUE(KeyboardReport(KC_LCTL, KC_C).Matches(reports[0])) << reports[0];
+    release_key(4, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(ReportBatch, KeysChangedInOneScanAreNotLost) {
+    TestDriver driver;
+    record(driver);
+    press_key(0, 0);
+    run_one_scan_loop();
+    // A rollover in a single scan, sent as one report
+    release_key(0, 0);
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(reports.size(), 3);
+    EXPECT_EQ(typed(), "ab");
+    EXPECT_TRUE(KeyboardReport().Matches(reports.back())) << reports.back();
+}
+
+TEST_F(ReportBatch, ADroppedReportIsSentAgain) {
+    TestDriver driver;
+    record(driver);
+    press_key(0, 0);
+    run_one_scan_loop();
+    // The host never gets the release
+    EXPECT_CALL(driver, send_keyboard_mock(testing::_))
+        .WillOnce(testing::InvokeWithoutArgs(host_keyboard_dropped))
+        .RetiresOnSaturation();
+    release_key(0, 0);
+    run_one_scan_loop();
+    clear_keyboard();
+    run_one_scan_loop();
+    EXPECT_EQ(driver.keyboard_reports(), 3);
+    ASSERT_EQ(reports.size(), 2);
+    EXPECT_TRUE(KeyboardReport().Matches(reports.back())) << reports.back();
+}
@@ -0,0 +1,110 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <random>
+
+extern "C" {
+    // Normally defined by the USB protocol
+    uint8_t keyboard_protocol = 1;
+}
+
+// The byte by byte versions that report.c used before scanning a word at a time
+static uint8_t reference_has_anykey(report_keyboard_t* keyboard_report) {
+    uint8_t cnt = 0;
+    for (uint8_t i = 1; i < KEYBOARD_REPORT_SIZE; i++) {
+        if (keyboard_report->raw[i])
+            cnt++;
+    }
+    return cnt;
+}
+
+static uint8_t reference_get_first_key(report_keyboard_t* keyboard_report) {
+    uint8_t i = 0;
+    for (; i < KEYBOARD_REPORT_BITS && !keyboard_report->nkro.bits[i]; i++)
+        ;
+    if (i == KEYBOARD_REPORT_BITS) {
+        return 0;
+    }
+    return i<<3 | biton(keyboard_report->nkro.bits[i]);
+}
+
+class ReportBitmap : public testing::Test {
+protected:
+    ReportBitmap() {
+        keymap_config.nkro = 1;
+    }
+    ~ReportBitmap() {
+        keymap_config.nkro = 0;
+    }
+
+    // Reports with up to max_keys keys, biased towards the few keys of real typing
+    std::vector<report_keyboard_t> random_reports(unsigned count, unsigned max_keys) {
+        std::vector<report_keyboard_t> reports(count);
+        for (report_keyboard_t& report : reports) {
+            report = {};
+            report.mods = random() & 0xFF;
+            unsigned keys = random() % (max_keys + 1);
+            for (unsigned k = 0; k < keys; k++) {
+                add_key_bit(&report, random() % (KEYBOARD_REPORT_BITS * 8));
+            }
+        }
+        return reports;
+    }
+
+    std::mt19937 random{1234};
+};
+
+TEST_F(ReportBitmap, EverySingleKeyIsFound) {
+    for (unsigned code = 0; code < KEYBOARD_REPORT_BITS * 8; code++) {
+        report_keyboard_t report = {};
+        report.mods = 0xFF;
+        add_key_bit(&report, code);
+        EXPECT_EQ(has_anykey(&report), 1) << "key " << code;
+        EXPECT_EQ(get_first_key(&report), code) << "key " << code;
+        del_key_bit(&report, code);
+        EXPECT_EQ(has_anykey(&report), 0) << "key " << code;
+    }
+}
+
+TEST_F(ReportBitmap, EmptyReportHasNoFirstKey) {
+    report_keyboard_t report = {};
+    report.mods = 0xFF;
+    EXPECT_EQ(has_anykey(&report), 0);
+    EXPECT_EQ(get_first_key(&report), 0);
+}
+
+TEST_F(ReportBitmap, MatchesTheByteImplementation) {
+    for (unsigned max_keys : {1, 2, 6, 20, 248}) {
+        for (report_keyboard_t& report : random_reports(2000, max_keys)) {
+            ASSERT_EQ(has_anykey(&report), reference_has_anykey(&report)) << report;
+            ASSERT_EQ(get_first_key(&report), reference_get_first_key(&report)) << report;
+        }
+    }
+}
+
+TEST_F(ReportBitmap, MatchesTheByteImplementationFor6KRO) {
+    keymap_config.nkro = 0;
+    for (unsigned i = 0; i < 2000; i++) {
+        report_keyboard_t report = {};
+        unsigned keys = random() % 7;
+        for (unsigned k = 0; k < keys; k++) {
+            add_key_byte(&report, 1 + random() % 0xFF);
+        }
+        ASSERT_EQ(has_anykey(&report), reference_has_anykey(&report)) << report;
+        ASSERT_EQ(get_first_key(&report), report.keys[0]) << report;
+    }
+}
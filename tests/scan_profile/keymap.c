@@ -0,0 +1,40 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+#include "scan_profile.h"
+
+enum custom_keycodes {
+    // Takes SLOW_KEY_NS of real time to process
+    SLOW = SAFE_RANGE,
+};
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {SLOW, KC_A, KC_B, KC_C},
+        {KC_D, KC_E, KC_F, KC_G},
+    },
+};
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (keycode == SLOW) {
+        uint32_t start = scan_profile_clock();
+        while (scan_profile_clock() - start < SLOW_KEY_NS) {
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,98 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "scan_profile.h"
+
+using testing::_;
+using testing::AnyNumber;
+
+class ScanProfile : public TestFixture {
+protected:
+    ScanProfile() {
+        scan_profile_reset();
+    }
+
+    static uint32_t count(scan_profile_probe_t probe) {
+        return scan_profile_get(probe)->count;
+    }
+};
+
+TEST_F(ScanProfile, EveryScanIsCounted) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    idle_for(10);
+    EXPECT_EQ(count(SCAN_PROFILE_KEYBOARD_TASK), 10);
+    EXPECT_EQ(count(SCAN_PROFILE_MATRIX_SCAN), 10);
+    // A tick when there's no key event
+    EXPECT_EQ(count(SCAN_PROFILE_ACTION_EXEC), 10);
+    EXPECT_EQ(count(SCAN_PROFILE_PROCESS_RECORD), 0);
+    // Not enabled in this build
+    EXPECT_EQ(count(SCAN_PROFILE_MOUSEKEY), 0);
+    EXPECT_EQ(count(SCAN_PROFILE_VISUALIZER), 0);
+}
+
+TEST_F(ScanProfile, KeysAreTimedThroughTheStages) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(count(SCAN_PROFILE_PROCESS_RECORD), 2);
+    EXPECT_EQ(count(SCAN_PROFILE_USB_SEND), 2);
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    const scan_profile_stats_t* process_record = scan_profile_get(SCAN_PROFILE_PROCESS_RECORD);
+    const scan_profile_stats_t* action_exec = scan_profile_get(SCAN_PROFILE_ACTION_EXEC);
+    const scan_profile_stats_t* keyboard_task = scan_profile_get(SCAN_PROFILE_KEYBOARD_TASK);
+    EXPECT_GE(process_record->max, SLOW_KEY_NS);
+    // Each stage includes the ones it calls
+    EXPECT_GE(action_exec->max, process_record->max);
+    EXPECT_GE(keyboard_task->max, action_exec->max);
+    EXPECT_LT(process_record->min, SLOW_KEY_NS);
+    EXPECT_GT(scan_profile_average(SCAN_PROFILE_PROCESS_RECORD), process_record->min);
+    EXPECT_LT(scan_profile_average(SCAN_PROFILE_PROCESS_RECORD), process_record->max);
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(ScanProfile, HistogramCountsEveryRun) {
+    scan_profile_record(SCAN_PROFILE_USB_SEND, 0);
+    scan_profile_record(SCAN_PROFILE_USB_SEND, 7);
+    scan_profile_record(SCAN_PROFILE_USB_SEND, 8);
+    scan_profile_record(SCAN_PROFILE_USB_SEND, 63);
+    scan_profile_record(SCAN_PROFILE_USB_SEND, 64);
+    scan_profile_record(SCAN_PROFILE_USB_SEND, UINT32_MAX);
+    const scan_profile_stats_t* usb_send = scan_profile_get(SCAN_PROFILE_USB_SEND);
+    const uint16_t expected[SCAN_PROFILE_BUCKETS] = {2, 2, 1, 0, 0, 0, 0, 1};
+    for (uint8_t bucket = 0; bucket < SCAN_PROFILE_BUCKETS; bucket++) {
+        EXPECT_EQ(usb_send->histogram[bucket], expected[bucket]) << "bucket " << (int)bucket;
+    }
+    EXPECT_EQ(usb_send->min, 0);
+    EXPECT_EQ(usb_send->max, UINT32_MAX);
+    // The total overflowed, and was halved with the count
+    EXPECT_EQ(usb_send->count, 3);
+}
+
+TEST_F(ScanProfile, LongIdleIsCountedAndPrinted) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    idle_for(1000);
+    EXPECT_EQ(count(SCAN_PROFILE_KEYBOARD_TASK), 1000);
+    scan_profile_print();
+}
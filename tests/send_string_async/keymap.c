@@ -0,0 +1,77 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+#include "recorded_callbacks.h"
+
+enum custom_keycodes {
+    ALPHABET = SAFE_RANGE,
+    SLOW,
+    SHIFTED,
+    CANCEL,
+    RETRY,
+};
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {ALPHABET, SLOW, SHIFTED, CANCEL, KC_1, KC_2, RETRY},
+    },
+};
+
+uint8_t completed_count = 0;
+uint8_t cancelled_count = 0;
+
+static void done(bool completed) {
+    if (completed) {
+        completed_count++;
+    } else {
+        cancelled_count++;
+    }
+}
+
+// Sends another string when cancelled
+static void retry(bool completed) {
+    done(completed);
+    if (!completed) {
+        send_string_async_P(PSTR("r"), 0, done);
+    }
+}
+
+static char ram_string[] = "xyz";
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return true;
+    }
+    switch (keycode) {
+    case ALPHABET:
+        send_string_async_P(PSTR("abcdefghij"), 0, done);
+        return false;
+    case SLOW:
+        send_string_async(ram_string, 10, done);
+        return false;
+    case SHIFTED:
+        send_string_async_P(PSTR(SS_DOWN(X_LSHIFT) "abcdefghij" SS_UP(X_LSHIFT)), 0, done);
+        return false;
+    case RETRY:
+        send_string_async_P(PSTR("abcdefghij"), 10, retry);
+        return false;
+    case CANCEL:
+        send_string_async_cancel();
+        return false;
+    }
+    return true;
+}
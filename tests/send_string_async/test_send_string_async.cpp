@@ -0,0 +1,124 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "recorded_callbacks.h"
+
+class SendStringAsync : public TestFixture {
+protected:
+    SendStringAsync() {
+        completed_count = 0;
+        cancelled_count = 0;
+    }
+
+    ~SendStringAsync() {
+        send_string_async_cancel();
+    }
+
+    void tap_key(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+    }
+};
+
+TEST_F(SendStringAsync, OneCharacterIsSentPerScan) {
+    TestDriver driver;
+    record(driver);
+    tap_key(0);
+    EXPECT_EQ(typed(), "a");
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "ab");
+    idle_for(8);
+    EXPECT_EQ(typed(), "abcdefghij");
+    EXPECT_EQ(completed_count, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(completed_count, 1);
+    EXPECT_FALSE(send_string_async_busy());
+}
+
+TEST_F(SendStringAsync, KeysPressedDuringTheStringAreReported) {
+    TestDriver driver;
+    record(driver);
+    tap_key(0);
+    run_one_scan_loop();
+    press_key(4, 0);
+    run_one_scan_loop();
+    // Reported in the same scan, and held in the reports of the characters after it
+    EXPECT_EQ(typed(), "ab1c");
+    EXPECT_TRUE(KeyboardReport(KC_1, KC_C).Matches(reports[reports.size() - 2])) << reports[reports.size() - 2];
+    EXPECT_TRUE(KeyboardReport(KC_1).Matches(reports.back())) << reports.back();
+    release_key(4, 0);
+    idle_for(10);
+    EXPECT_EQ(completed_count, 1);
+    EXPECT_EQ(typed(), "ab1cdefghij");
+    EXPECT_TRUE(KeyboardReport().Matches(reports.back())) << reports.back();
+}
+
+TEST_F(SendStringAsync, IntervalPacesTheCharacters) {
+    TestDriver driver;
+    record(driver);
+    tap_key(1);
+    EXPECT_EQ(typed(), "x");
+    idle_for(9);
+    EXPECT_EQ(typed(), "x");
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "xy");
+    idle_for(10);
+    EXPECT_EQ(typed(), "xyz");
+    idle_for(10);
+    EXPECT_EQ(completed_count, 1);
+}
+
+TEST_F(SendStringAsync, StringsAreSentInOrder) {
+    TestDriver driver;
+    record(driver);
+    tap_key(1);
+    tap_key(0);
+    idle_for(50);
+    EXPECT_EQ(typed(), "xyzabcdefghij");
+    EXPECT_EQ(completed_count, 2);
+}
+
+TEST_F(SendStringAsync, CancelReleasesTheHeldKeys) {
+    TestDriver driver;
+    record(driver);
+    tap_key(2);
+    idle_for(3);
+    EXPECT_EQ(typed(), "ABC");
+    tap_key(3);
+    EXPECT_TRUE(KeyboardReport().Matches(reports.back())) << reports.back();
+    EXPECT_FALSE(send_string_async_busy());
+    EXPECT_EQ(cancelled_count, 1);
+    EXPECT_EQ(completed_count, 0);
+    idle_for(10);
+    EXPECT_EQ(typed(), "ABC");
+}
+
+TEST_F(SendStringAsync, CancelKeepsTheStringsQueuedByItsCallbacks) {
+    TestDriver driver;
+    record(driver);
+    tap_key(6);
+    idle_for(1);
+    EXPECT_EQ(typed(), "a");
+    tap_key(3);
+    EXPECT_EQ(cancelled_count, 1);
+    EXPECT_TRUE(send_string_async_busy());
+    idle_for(10);
+    EXPECT_EQ(typed(), "ar");
+    EXPECT_EQ(completed_count, 1);
+    EXPECT_FALSE(send_string_async_busy());
+}
@@ -0,0 +1,33 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// A typing layout with home row shifts and a layer on the space bar
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_ESC,  KC_Q,    KC_W,    KC_E,    KC_R,        KC_T,         KC_Y,    KC_U,        KC_I,    KC_O,    KC_P,    KC_BSPC},
+        {KC_TAB,  KC_A,    KC_S,    KC_D,    SFT_T(KC_F), KC_G,         KC_H,    SFT_T(KC_J), KC_K,    KC_L,    KC_SCLN, KC_ENT},
+        {KC_LSFT, KC_Z,    KC_X,    KC_C,    KC_V,        KC_B,         KC_N,    KC_M,        KC_COMM, KC_DOT,  KC_SLSH, KC_RSFT},
+        {KC_LCTL, KC_LGUI, KC_LALT, KC_NO,   KC_NO,       LT(1,KC_SPC), KC_SPC,  KC_NO,       KC_NO,   KC_RALT, KC_RGUI, KC_RCTL},
+    },
+    [1] = {
+        {KC_GRV,  KC_1,    KC_2,    KC_3,    KC_4,        KC_5,         KC_6,    KC_7,        KC_8,    KC_9,    KC_0,    KC_DEL},
+        {KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,     KC_TRNS,      KC_LEFT, KC_DOWN,     KC_UP,   KC_RGHT, KC_TRNS, KC_TRNS},
+        {KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,     KC_TRNS,      KC_TRNS, KC_TRNS,     KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS},
+        {KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS,     KC_TRNS,      KC_TRNS, KC_TRNS,     KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS},
+    },
+};
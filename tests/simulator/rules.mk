@@ -0,0 +1,36 @@
+# Copyright 2017 QMK Firmware contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Replays a keystroke trace through keyboard_task(), see docs/unit_testing.md
+#   make test:simulator SIMULATOR_TRACE=path/to/trace
+#   make test:simulator SIMULATOR_KEYBOARD=planck SIMULATOR_KEYMAP=default
+CUSTOM_MATRIX = yes
+
+SIMULATOR_TRACE ?= tests/simulator/typing.trace
+OPT_DEFS += -DSIMULATOR_TRACE=\"$(SIMULATOR_TRACE)\"
+
+ifdef SIMULATOR_KEYBOARD
+    SIMULATOR_KEYMAP ?= default
+    SIMULATOR_KEYBOARD_PATH := keyboards/$(SIMULATOR_KEYBOARD)
+    SIMULATOR_KEYMAP_PATH := $(SIMULATOR_KEYBOARD_PATH)/keymaps/$(SIMULATOR_KEYMAP)
+    TEST_KEYMAP := $(SIMULATOR_KEYMAP_PATH)/keymap.c
+    # The keymap config includes the keyboard one, when there is one
+    ifneq ($(wildcard $(SIMULATOR_KEYMAP_PATH)/config.h),)
+        TEST_CONFIG := $(SIMULATOR_KEYMAP_PATH)/config.h
+    else
+        TEST_CONFIG := $(SIMULATOR_KEYBOARD_PATH)/config.h
+    endif
+    VPATH += $(SIMULATOR_KEYMAP_PATH) $(SIMULATOR_KEYBOARD_PATH)
+endif
@@ -0,0 +1,151 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+using testing::_;
+using testing::Invoke;
+
+extern "C" {
+    void set_time(uint32_t t);
+}
+
+// Microseconds between two scans, the simulated timer itself only counts milliseconds
+#ifndef SIMULATOR_SCAN_PERIOD
+#define SIMULATOR_SCAN_PERIOD 1000
+#endif
+// How long to keep scanning after the last event, so that tap keys can settle
+#ifndef SIMULATOR_IDLE_TIME
+#define SIMULATOR_IDLE_TIME 1000000
+#endif
+
+struct trace_event_t {
+    uint64_t time;
+    uint8_t row;
+    uint8_t col;
+    bool pressed;
+};
+
+/* One event per line, "<time in microseconds> <row> <col> <d or u>",
+ * lines starting with # are comments */
+static std::vector<trace_event_t> read_trace(const char* path) {
+    std::vector<trace_event_t> trace;
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        ADD_FAILURE() << "can't open the trace " << path;
+        return trace;
+    }
+    char line[128];
+    unsigned number = 0;
+    while (fgets(line, sizeof(line), file)) {
+        number++;
+        unsigned long long time;
+        unsigned row, col;
+        char state;
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%llu %u %u %c", &time, &row, &col, &state) != 4 ||
+            row >= MATRIX_ROWS || col >= MATRIX_COLS || (state != 'd' && state != 'u')) {
+            ADD_FAILURE() << path << ":" << number << ": bad event " << line;
+            continue;
+        }
+        if (!trace.empty() && time < trace.back().time) {
+            ADD_FAILURE() << path << ":" << number << ": events are not in time order";
+        }
+        trace.push_back({time, (uint8_t)row, (uint8_t)col, state == 'd'});
+    }
+    fclose(file);
+    return trace;
+}
+
+static uint64_t percentile(const std::vector<uint64_t>& sorted, unsigned p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    return sorted[(sorted.size() - 1) * p / 100];
+}
+
+class Simulator : public TestFixture {};
+
+/* Every event waits for the next report, so a tap key is measured until it
+ * has been settled, and a key that is eaten by a feature until the report
+ * that follows it */
+TEST_F(Simulator, ReplayTrace) {
+    const char* path = getenv("SIMULATOR_TRACE");
+    std::vector<trace_event_t> trace = read_trace(path ? path : SIMULATOR_TRACE);
+    ASSERT_FALSE(trace.empty());
+
+    TestDriver driver;
+    uint64_t now = trace.front().time;
+    std::deque<uint64_t> pending;
+    std::vector<uint64_t> latencies;
+    unsigned reports = 0;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&](report_keyboard_t&) {
+        reports++;
+        for (uint64_t time : pending) {
+            latencies.push_back(now - time);
+        }
+        pending.clear();
+    }));
+
+    using clock = std::chrono::steady_clock;
+    clock::duration busy = clock::duration::zero();
+    unsigned scans = 0;
+    size_t next = 0;
+    uint64_t end = trace.back().time + SIMULATOR_IDLE_TIME;
+    while (now < end) {
+        for (; next < trace.size() && trace[next].time <= now; next++) {
+            const trace_event_t& event = trace[next];
+            if (event.pressed) {
+                press_key(event.col, event.row);
+            } else {
+                release_key(event.col, event.row);
+            }
+            pending.push_back(event.time);
+        }
+        set_time(now / 1000);
+        clock::time_point start = clock::now();
+        keyboard_task();
+        busy += clock::now() - start;
+        scans++;
+        now += SIMULATOR_SCAN_PERIOD;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double seconds = std::chrono::duration<double>(busy).count();
+    printf("%zu events, %u reports, %zu events without a report\n", trace.size(), reports, pending.size());
+    printf("scan to report latency (us): p50 %llu, p90 %llu, p99 %llu, max %llu\n",
+        (unsigned long long)percentile(latencies, 50), (unsigned long long)percentile(latencies, 90),
+        (unsigned long long)percentile(latencies, 99), (unsigned long long)percentile(latencies, 100));
+    printf("host: %.0f scans/s, %.0f reports/s\n", scans / seconds, reports / seconds);
+
+    // Only for keymaps where every key ends up in a report
+    if (getenv("SIMULATOR_ALL_REPORTED")) {
+        EXPECT_TRUE(pending.empty());
+    }
+    const char* budget = getenv("SIMULATOR_MAX_P99");
+    if (budget) {
+        EXPECT_LE(percentile(latencies, 99), strtoull(budget, NULL, 10));
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
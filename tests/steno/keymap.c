@@ -0,0 +1,46 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "quantum.h"
+#include "keymap_steno.h"
+#include "virtser.h"
+#include "recorded_writes.h"
+
+// Every steno key in GeminiPR order, twelve to a row
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {STN_FN,  STN_N1,  STN_N2,  STN_N3,  STN_N4,  STN_N5,  STN_N6,  STN_S1,  STN_S2,  STN_TL,  STN_KL,  STN_PL},
+        {STN_WL,  STN_HL,  STN_RL,  STN_A,   STN_O,   STN_ST1, STN_ST2, STN_RE1, STN_RE2, STN_PWR, STN_ST3, STN_ST4},
+        {STN_E,   STN_U,   STN_FR,  STN_RR,  STN_PR,  STN_BR,  STN_LR,  STN_GR,  STN_TR,  STN_SR,  STN_DR,  STN_N7},
+        {STN_N8,  STN_N9,  STN_NA,  STN_NB,  STN_NC,  STN_ZR,  QK_STENO_REPEAT, QK_STENO_BOLT, QK_STENO_GEMINI, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+recorded_write_t recorded_writes[MAX_RECORDED_WRITES];
+uint16_t recorded_write_count;
+
+void virtser_send_buffer(const uint8_t *data, const uint8_t length) {
+    if (recorded_write_count < MAX_RECORDED_WRITES) {
+        recorded_write_t *write = &recorded_writes[recorded_write_count++];
+        write->length = length;
+        memcpy(write->data, data, length);
+    }
+}
+
+void virtser_send(const uint8_t byte) {
+    virtser_send_buffer(&byte, 1);
+}
@@ -0,0 +1,42 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_STENO_RECORDED_WRITES_H_
+#define TESTS_STENO_RECORDED_WRITES_H_
+
+#include <stdint.h>
+
+#define MAX_RECORDED_WRITES 1024
+#define MAX_WRITE_LENGTH 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint8_t length;
+    uint8_t data[MAX_WRITE_LENGTH];
+} recorded_write_t;
+
+// The virtual serial writes, in order
+extern recorded_write_t recorded_writes[MAX_RECORDED_WRITES];
+extern uint16_t recorded_write_count;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TESTS_STENO_RECORDED_WRITES_H_ */
@@ -0,0 +1,268 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "keymap_steno.h"
+#include "recorded_writes.h"
+#include <vector>
+
+using testing::_;
+using testing::AnyNumber;
+
+typedef std::vector<uint8_t> packet_t;
+typedef std::vector<uint8_t> chord_t;
+
+class Steno : public TestFixture {
+protected:
+    Steno() {
+        recorded_write_count = 0;
+        steno_init();
+        steno_set_chord_mode(STENO_CHORD_ALL_UP);
+        steno_set_mode(STENO_MODE_BOLT);
+    }
+
+    // Steno keys are numbered in GeminiPR order, like the keymap
+    void press(uint8_t key) {
+        press_key(key % MATRIX_COLS, key / MATRIX_COLS);
+    }
+
+    void release(uint8_t key) {
+        release_key(key % MATRIX_COLS, key / MATRIX_COLS);
+    }
+
+    void tap(uint16_t keycode) {
+        // The keys after the steno keys
+        uint8_t key = keycode - QK_STENO;
+        switch (keycode) {
+        case QK_STENO_REPEAT: key = STN__MAX - STN__MIN + 1; break;
+        case QK_STENO_BOLT: key = STN__MAX - STN__MIN + 2; break;
+        case QK_STENO_GEMINI: key = STN__MAX - STN__MIN + 3; break;
+        }
+        press(key);
+        run_one_scan_loop();
+        release(key);
+        run_one_scan_loop();
+    }
+
+    // A key a scan, as fast as the matrix picks them up
+    void stroke(const chord_t& chord) {
+        for (uint8_t key : chord) {
+            press(key);
+            run_one_scan_loop();
+        }
+        for (uint8_t key : chord) {
+            release(key);
+            run_one_scan_loop();
+        }
+    }
+
+    static packet_t written(uint16_t index) {
+        const recorded_write_t& write = recorded_writes[index];
+        return packet_t(write.data, write.data + write.length);
+    }
+
+    // The GeminiPR packet, from the protocol: one bit per key, seven to a
+    // byte, and the first byte marked
+    static packet_t gemini(const chord_t& chord) {
+        packet_t packet(6, 0);
+        for (uint8_t key : chord) {
+            packet[key / 7] |= 1 << (6 - key % 7);
+        }
+        packet[0] |= 0x80;
+        return packet;
+    }
+
+    // The TX Bolt packet, from the protocol: the 24 keys STKPWH RAO*EU FRPBLG
+    // TSDZ#, six to a group, with the group in the top bits. Only the groups
+    // with keys are sent, then a zero.
+    static packet_t bolt(const chord_t& chord) {
+        static const int8_t bolt_key[STN__MAX - STN__MIN + 1] = {
+            -1, 22, 22, 22, 22, 22, 22,   // Fn, #1 to #6
+            0, 0, 1, 2, 3, 4, 5,          // S1 S2 T K P W H
+            6, 7, 8, 9, 9, -1, -1,        // R A O *1 *2 res1 res2
+            -1, 9, 9, 10, 11, 12, 13,     // pwr *3 *4 E U F R
+            14, 15, 16, 17, 18, 19, 20,   // P B L G T S D
+            22, 22, 22, 22, 22, 22, 21,   // #7 to #C, Z
+        };
+        uint8_t groups[4] = {0};
+        for (uint8_t key : chord) {
+            int8_t bolt = bolt_key[key];
+            if (bolt >= 0) {
+                groups[bolt / 6] |= (bolt / 6) << 6 | 1 << (bolt % 6);
+            }
+        }
+        packet_t packet;
+        for (uint8_t group : groups) {
+            if (group) {
+                packet.push_back(group);
+            }
+        }
+        packet.push_back(0);
+        return packet;
+    }
+};
+
+static uint8_t key(uint16_t keycode) {
+    return keycode - STN__MIN;
+}
+
+static const chord_t KAT = {key(STN_KL), key(STN_A), key(STN_TR)};
+
+TEST_F(Steno, TxBoltPackets) {
+    TestDriver driver;
+    stroke(KAT);
+    stroke({key(STN_S2)});
+    stroke({key(STN_N3), key(STN_ZR)});
+    run_one_scan_loop();
+    ASSERT_EQ(recorded_write_count, 3);
+    EXPECT_EQ(written(0), packet_t({0x04, 0x42, 0xC1, 0x00}));
+    EXPECT_EQ(written(1), packet_t({0x01, 0x00}));
+    EXPECT_EQ(written(2), packet_t({0xD8, 0x00}));
+}
+
+TEST_F(Steno, GeminiPacketsAreAlwaysSixBytes) {
+    TestDriver driver;
+    tap(QK_STENO_GEMINI);
+    stroke(KAT);
+    stroke({key(STN_FN), key(STN_ZR)});
+    run_one_scan_loop();
+    ASSERT_EQ(recorded_write_count, 2);
+    EXPECT_EQ(written(0), packet_t({0x80, 0x08, 0x20, 0x00, 0x04, 0x00}));
+    EXPECT_EQ(written(1), packet_t({0xC0, 0x00, 0x00, 0x00, 0x00, 0x01}));
+}
+
+TEST_F(Steno, EveryStrokeIsOneWriteAtHighStrokeRates) {
+    TestDriver driver;
+    for (steno_mode_t mode : {STENO_MODE_BOLT, STENO_MODE_GEMINI}) {
+        steno_set_mode(mode);
+        recorded_write_count = 0;
+        std::vector<chord_t> chords;
+        uint32_t seed = 42;
+        // Far faster than anyone writes
+        for (int i = 0; i < 500; i++) {
+            chord_t chord;
+            for (uint8_t k = 0; k <= STN__MAX - STN__MIN; k++) {
+                seed = seed * 1103515245 + 12345;
+                if ((seed >> 16) % 6 == 0) {
+                    chord.push_back(k);
+                }
+            }
+            if (chord.empty()) {
+                chord.push_back(key(STN_A));
+            }
+            stroke(chord);
+            chords.push_back(chord);
+        }
+        idle_for(STENO_QUEUE_SIZE);
+        ASSERT_EQ(recorded_write_count, chords.size());
+        for (size_t i = 0; i < chords.size(); i++) {
+            EXPECT_EQ(written(i), mode == STENO_MODE_BOLT ? bolt(chords[i]) : gemini(chords[i])) << "stroke " << i;
+        }
+    }
+}
+
+TEST_F(Steno, BurstsLongerThanTheQueueKeepTheirOrder) {
+    std::vector<chord_t> chords;
+    for (uint8_t i = 0; i < 3 * STENO_QUEUE_SIZE; i++) {
+        chord_t chord = {i, (uint8_t)(i + 13)};
+        keyrecord_t record = {};
+        for (uint8_t k : chord) {
+            record.event = (keyevent_t){.key = {}, .pressed = true, .time = 1};
+            process_steno(STN__MIN + k, &record);
+        }
+        for (uint8_t k : chord) {
+            record.event = (keyevent_t){.key = {}, .pressed = false, .time = 1};
+            process_steno(STN__MIN + k, &record);
+        }
+        chords.push_back(chord);
+    }
+    EXPECT_EQ(steno_queued_strokes(), STENO_QUEUE_SIZE);
+    while (steno_queued_strokes()) {
+        steno_task();
+    }
+    ASSERT_EQ(recorded_write_count, chords.size());
+    for (size_t i = 0; i < chords.size(); i++) {
+        EXPECT_EQ(written(i), bolt(chords[i])) << "stroke " << i;
+    }
+}
+
+TEST_F(Steno, RepeatSendsTheLastStrokeInTheCurrentMode) {
+    TestDriver driver;
+    stroke(KAT);
+    tap(QK_STENO_REPEAT);
+    tap(QK_STENO_GEMINI);
+    tap(QK_STENO_REPEAT);
+    run_one_scan_loop();
+    ASSERT_EQ(recorded_write_count, 3);
+    EXPECT_EQ(written(0), bolt(KAT));
+    EXPECT_EQ(written(1), bolt(KAT));
+    EXPECT_EQ(written(2), gemini(KAT));
+}
+
+TEST_F(Steno, RepeatSendsNothingBeforeTheFirstStroke) {
+    TestDriver driver;
+    tap(QK_STENO_REPEAT);
+    run_one_scan_loop();
+    EXPECT_EQ(recorded_write_count, 0);
+}
+
+TEST_F(Steno, FirstUpSendsOnTheFirstRelease) {
+    TestDriver driver;
+    steno_set_chord_mode(STENO_CHORD_FIRST_UP);
+    press(key(STN_S1));
+    run_one_scan_loop();
+    press(key(STN_TL));
+    run_one_scan_loop();
+    release(key(STN_TL));
+    idle_for(2);
+    ASSERT_EQ(recorded_write_count, 1);
+    EXPECT_EQ(written(0), bolt({key(STN_S1), key(STN_TL)}));
+
+    // S is still held, and goes into the next stroke
+    press(key(STN_KL));
+    run_one_scan_loop();
+    release(key(STN_KL));
+    idle_for(2);
+    release(key(STN_S1));
+    idle_for(2);
+    ASSERT_EQ(recorded_write_count, 2);
+    EXPECT_EQ(written(1), bolt({key(STN_S1), key(STN_KL)}));
+}
+
+TEST_F(Steno, FirstDownSendsAfterTheChordTerm) {
+    TestDriver driver;
+    steno_set_chord_mode(STENO_CHORD_FIRST_DOWN);
+    press(key(STN_S1));
+    idle_for(10);
+    press(key(STN_TL));
+    idle_for(STENO_CHORD_TERM - 12);
+    EXPECT_EQ(recorded_write_count, 0);
+    idle_for(3);
+    ASSERT_EQ(recorded_write_count, 1);
+    EXPECT_EQ(written(0), bolt({key(STN_S1), key(STN_TL)}));
+
+    // Keys pressed after it start a chord of their own
+    press(key(STN_KL));
+    run_one_scan_loop();
+    release(key(STN_S1));
+    run_one_scan_loop();
+    release(key(STN_TL));
+    run_one_scan_loop();
+    release(key(STN_KL));
+    idle_for(2);
+    ASSERT_EQ(recorded_write_count, 2);
+    EXPECT_EQ(written(1), bolt({key(STN_KL)}));
+}
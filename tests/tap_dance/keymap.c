@@ -0,0 +1,50 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+#include "recorded_dances.h"
+
+// Each row ends with a plain key
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {TD(0),  TD(1),  TD(2),  TD(3),  TD(4),  TD(5),  TD(6),  TD(7),  TD(8),  TD(9),  TD(10), TD(11), KC_A},
+        {TD(12), TD(13), TD(14), TD(15), TD(16), TD(17), TD(18), TD(19), TD(20), TD(21), TD(22), TD(23), KC_B},
+        {TD(24), TD(25), TD(26), TD(27), TD(28), TD(29), TD(30), TD(31), TD(32), TD(33), TD(34), TD(35), KC_C},
+        {TD(36), TD(37), TD(38), TD(39), TD(40), TD(41), TD(42), TD(43), TD(44), TD(45), TD(46), TD(47), KC_D},
+    },
+};
+
+uint8_t finished_count[DANCE_COUNT];
+uint8_t reset_count[DANCE_COUNT];
+uint8_t finished_taps[DANCE_COUNT];
+
+static void dance_finished(qk_tap_dance_state_t *state, void *user_data) {
+    uint8_t dance = state->keycode - QK_TAP_DANCE;
+    finished_count[dance]++;
+    finished_taps[dance] = state->count;
+}
+
+static void dance_reset(qk_tap_dance_state_t *state, void *user_data) {
+    reset_count[state->keycode - QK_TAP_DANCE]++;
+}
+
+#define DANCE ACTION_TAP_DANCE_FN_ADVANCED(NULL, dance_finished, dance_reset)
+#define SHORT_DANCE ACTION_TAP_DANCE_FN_ADVANCED_TIME(NULL, dance_finished, dance_reset, SHORT_TAPPING_TERM)
+#define DANCES_8 DANCE, SHORT_DANCE, DANCE, SHORT_DANCE, DANCE, SHORT_DANCE, DANCE, SHORT_DANCE
+
+qk_tap_dance_action_t tap_dance_actions[] = {
+    DANCES_8, DANCES_8, DANCES_8, DANCES_8, DANCES_8, DANCES_8,
+};
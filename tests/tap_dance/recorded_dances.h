@@ -0,0 +1,35 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DANCE_COUNT 48
+
+// How many times each dance has finished and been reset
+extern uint8_t finished_count[DANCE_COUNT];
+extern uint8_t reset_count[DANCE_COUNT];
+// The tap count each dance last finished with
+extern uint8_t finished_taps[DANCE_COUNT];
+
+#ifdef __cplusplus
+}
+#endif
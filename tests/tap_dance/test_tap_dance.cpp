@@ -0,0 +1,135 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "recorded_dances.h"
+#include <cstring>
+
+using testing::_;
+using testing::AnyNumber;
+
+class TapDance : public TestFixture {
+protected:
+    TapDance() {
+        memset(finished_count, 0, sizeof(finished_count));
+        memset(reset_count, 0, sizeof(reset_count));
+        memset(finished_taps, 0, sizeof(finished_taps));
+    }
+
+    void press_dance(uint8_t dance) {
+        press_key(dance % 12, dance / 12);
+        run_one_scan_loop();
+    }
+
+    void release_dance(uint8_t dance) {
+        release_key(dance % 12, dance / 12);
+        run_one_scan_loop();
+    }
+
+    void tap_dance(uint8_t dance) {
+        press_dance(dance);
+        release_dance(dance);
+    }
+};
+
+TEST_F(TapDance, EachDanceTimesOutWithItsOwnTerm) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (uint8_t dance : {0, 1}) {
+        uint16_t term = dance % 2 ? SHORT_TAPPING_TERM : TAPPING_TERM;
+        tap_dance(dance);
+        tap_dance(dance);
+        // The second tap restarted the term
+        idle_for(term - 1);
+        EXPECT_EQ(finished_count[dance], 0) << "dance " << (int)dance;
+        idle_for(2);
+        EXPECT_EQ(finished_count[dance], 1) << "dance " << (int)dance;
+        EXPECT_EQ(finished_taps[dance], 2) << "dance " << (int)dance;
+        EXPECT_EQ(reset_count[dance], 1) << "dance " << (int)dance;
+    }
+}
+
+TEST_F(TapDance, ManyHeldDancesFinishAndResetOnce) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    // Each dance interrupts the one before, which stays pressed
+    for (uint8_t dance = 0; dance < DANCE_COUNT; dance++) {
+        press_dance(dance);
+        if (dance) {
+            EXPECT_EQ(finished_count[dance - 1], 1) << "dance " << (int)dance - 1;
+        }
+    }
+    idle_for(TAPPING_TERM + 1);
+    for (uint8_t dance = 0; dance < DANCE_COUNT; dance++) {
+        EXPECT_EQ(finished_count[dance], 1) << "dance " << (int)dance;
+        EXPECT_EQ(reset_count[dance], 0) << "dance " << (int)dance;
+    }
+    // Each one is reset on the scan after its release
+    for (int8_t dance = DANCE_COUNT - 1; dance >= 0; dance--) {
+        release_dance(dance);
+        run_one_scan_loop();
+        EXPECT_EQ(reset_count[dance], 1) << "dance " << (int)dance;
+    }
+    idle_for(TAPPING_TERM + 1);
+    for (uint8_t dance = 0; dance < DANCE_COUNT; dance++) {
+        EXPECT_EQ(finished_count[dance], 1) << "dance " << (int)dance;
+        EXPECT_EQ(reset_count[dance], 1) << "dance " << (int)dance;
+        EXPECT_EQ(finished_taps[dance], 1) << "dance " << (int)dance;
+    }
+}
+
+TEST_F(TapDance, PlainKeyInterruptsEveryActiveDance) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    // Held dances spread over the index range
+    for (uint8_t dance : {3, 17, 40}) {
+        press_dance(dance);
+    }
+    tap_dance(46);
+    EXPECT_EQ(finished_count[40], 1);
+    EXPECT_EQ(finished_count[46], 0);
+    press_key(12, 0);
+    run_one_scan_loop();
+    for (uint8_t dance : {3, 17, 40, 46}) {
+        EXPECT_EQ(finished_count[dance], 1) << "dance " << (int)dance;
+    }
+    EXPECT_EQ(reset_count[46], 1);
+    release_key(12, 0);
+    for (uint8_t dance : {3, 17, 40}) {
+        EXPECT_EQ(reset_count[dance], 0) << "dance " << (int)dance;
+        release_dance(dance);
+    }
+    idle_for(TAPPING_TERM + 1);
+    for (uint8_t dance : {3, 17, 40, 46}) {
+        EXPECT_EQ(finished_count[dance], 1) << "dance " << (int)dance;
+        EXPECT_EQ(reset_count[dance], 1) << "dance " << (int)dance;
+    }
+}
+
+TEST_F(TapDance, NoDanceIsVisitedBeforeTheDeadline) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_dance(0);
+    // Dance 0 looks timed out now, but the deadline is still its term away,
+    // so the scans don't look at it
+    tap_dance_actions[0].state.timer -= TAPPING_TERM + 1;
+    for (uint16_t i = 0; i < TAPPING_TERM; i++) {
+        matrix_scan_tap_dance();
+    }
+    EXPECT_EQ(finished_count[0], 0);
+    idle_for(TAPPING_TERM + 1);
+    EXPECT_EQ(finished_count[0], 1);
+}
@@ -0,0 +1,33 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {SFT_T(KC_A), CTL_T(KC_S), KC_X, KC_Y},
+    },
+};
+
+// Zero uses TAPPING_TERM
+static const uint16_t PROGMEM tapping_terms[MATRIX_ROWS][MATRIX_COLS] = {
+    {150, 0, 0, 0},
+};
+
+uint16_t get_tapping_term(keypos_t key) {
+    uint16_t term = pgm_read_word(&tapping_terms[key.row][key.col]);
+    return term ? term : TAPPING_TERM;
+}
@@ -0,0 +1,93 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "timer.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::InvokeWithoutArgs;
+
+class TappingPerKey : public TestFixture {
+protected:
+    // Holds the key until it has been settled, and returns how long that took
+    uint16_t hold_latency(uint8_t col, uint8_t mod) {
+        TestDriver driver;
+        uint16_t resolved = 0;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(mod)))
+            .WillOnce(InvokeWithoutArgs([&resolved]() { resolved = timer_read(); }));
+        press_key(col, 0);
+        uint16_t pressed = timer_read();
+        for (unsigned i = 0; i < 2 * TAPPING_TERM && !resolved; i++) {
+            run_one_scan_loop();
+        }
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        release_key(col, 0);
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        run_one_scan_loop();
+        return TIMER_DIFF_16(resolved, pressed);
+    }
+};
+
+TEST_F(TappingPerKey, LookupFallsBackToTheGlobalTerm) {
+    EXPECT_EQ(get_tapping_term((keypos_t){.col = 0, .row = 0}), 150);
+    EXPECT_EQ(get_tapping_term((keypos_t){.col = 1, .row = 0}), TAPPING_TERM);
+}
+
+TEST_F(TappingPerKey, HoldIsDecidedAfterTheTermOfThatKey) {
+    uint16_t short_term = hold_latency(0, KC_LSFT);
+    uint16_t default_term = hold_latency(1, KC_LCTL);
+    EXPECT_GE(short_term, 150);
+    EXPECT_LE(short_term, 150 + 2);
+    EXPECT_GE(default_term, TAPPING_TERM);
+    EXPECT_LE(default_term, TAPPING_TERM + 2);
+}
+
+TEST_F(TappingPerKey, TapWithinTheLongerTermIsStillATap) {
+    TestDriver driver;
+    InSequence s;
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(200);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_S)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(TappingPerKey, EarlyResolveDecidesHoldWhenTheNextKeyIsReleased) {
+    TestDriver driver;
+    InSequence s;
+    uint16_t resolved = 0;
+    press_key(0, 0);
+    uint16_t pressed = timer_read();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(20);
+    press_key(2, 0);
+    idle_for(30);
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)))
+        .WillOnce(InvokeWithoutArgs([&resolved]() { resolved = timer_read(); }));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_X)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    EXPECT_EQ(TIMER_DIFF_16(resolved, pressed), 50);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
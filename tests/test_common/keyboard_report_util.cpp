@@ -15,6 +15,8 @@
  */
 
  #include "keyboard_report_util.hpp"
+ #include "host.h"
+ #include "keycode_config.h"
  #include <vector>
  #include <algorithm>
  using namespace testing;
@@ -24,8 +26,16 @@
      std::vector<uint8_t> get_keys(const report_keyboard_t& report) {
         std::vector<uint8_t> result;
         #if defined(NKRO_ENABLE)
-        #error NKRO support not implemented yet
-        #elif defined(USB_6KRO_ENABLE)
+        if (keyboard_protocol && keymap_config.nkro) {
+            for(size_t i=0; i<KEYBOARD_REPORT_BITS * 8; i++) {
+                if (report.nkro.bits[i >> 3] & (1 << (i & 7))) {
+                    result.emplace_back(i);
+                }
+            }
+            return result;
+        }
+        #endif
+        #if defined(USB_6KRO_ENABLE)
         #error 6KRO support not implemented yet
         #else
         for(size_t i=0; i<KEYBOARD_REPORT_KEYS; i++) {
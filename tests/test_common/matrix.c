@@ -20,13 +20,32 @@
 #include <string.h>
 
 static matrix_row_t matrix[MATRIX_ROWS] = {};
+static matrix_changed_t rows_changed = 0;
+
+// Tests which define DEBOUNCING_DELAY see the pressed keys through the
+// debounce algorithm selected by DEBOUNCE_TYPE
+#ifdef DEBOUNCING_DELAY
+#include "debounce.h"
+static matrix_row_t raw_matrix[MATRIX_ROWS] = {};
+static bool raw_changed = false;
+#   define KEY_MATRIX raw_matrix
+#else
+#   define KEY_MATRIX matrix
+#endif
 
 void matrix_init(void) {
     clear_all_keys();
+#ifdef DEBOUNCING_DELAY
+    debounce_init(MATRIX_ROWS);
+#endif
     matrix_init_quantum();
 }
 
 uint8_t matrix_scan(void) {
+#ifdef DEBOUNCING_DELAY
+    rows_changed |= debounce(raw_matrix, matrix, MATRIX_ROWS, raw_changed);
+    raw_changed = false;
+#endif
     matrix_scan_quantum();
     return 1;
 }
@@ -35,6 +54,12 @@ matrix_row_t matrix_get_row(uint8_t row) {
     return matrix[row];
 }
 
+matrix_changed_t matrix_changed_rows(void) {
+    matrix_changed_t changed = rows_changed;
+    rows_changed = 0;
+    return changed;
+}
+
 void matrix_print(void) {
 
 }
@@ -48,15 +73,30 @@ void matrix_scan_kb(void) {
 }
 
 void press_key(uint8_t col, uint8_t row) {
-    matrix[row] |= 1 << col;
+    KEY_MATRIX[row] |= (matrix_row_t)1 << col;
+#ifdef DEBOUNCING_DELAY
+    raw_changed = true;
+#else
+    rows_changed |= (matrix_changed_t)1 << row;
+#endif
 }
 
 void release_key(uint8_t col, uint8_t row) {
-    matrix[row] &= ~(1 << col);
+    KEY_MATRIX[row] &= ~((matrix_row_t)1 << col);
+#ifdef DEBOUNCING_DELAY
+    raw_changed = true;
+#else
+    rows_changed |= (matrix_changed_t)1 << row;
+#endif
 }
 
 void clear_all_keys(void) {
-    memset(matrix, 0, sizeof(matrix));
+    memset(KEY_MATRIX, 0, sizeof(KEY_MATRIX));
+#ifdef DEBOUNCING_DELAY
+    raw_changed = true;
+#else
+    rows_changed = MATRIX_CHANGED_ALL;
+#endif
 }
 
 void led_set(uint8_t usb_led) {
@@ -40,6 +40,7 @@ uint8_t TestDriver::keyboard_leds(void) {
 }
 
 void TestDriver::send_keyboard(report_keyboard_t* report) {
+    m_this->m_keyboard_reports++;
     m_this->send_keyboard_mock(*report);
 
 }
@@ -5,6 +5,8 @@
 #include "keyboard.h"
 #include "action.h"
 #include "action_tapping.h"
+#include "keycode.h"
+#include <cctype>
 
 extern "C" {
     void set_time(uint32_t t);
@@ -12,6 +14,7 @@ extern "C" {
 }
 
 using testing::_;
+using testing::Invoke;
 using testing::AnyNumber;
 using testing::Return;
 using testing::Between;
@@ -48,4 +51,46 @@ void TestFixture::idle_for(unsigned time) {
     for (unsigned i=0; i<time; i++) {
         run_one_scan_loop();
     }
-}
\ No newline at end of file
+}
+
+void TestFixture::record(TestDriver& driver) {
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([this](report_keyboard_t& report) {
+        reports.push_back(report);
+    }));
+}
+
+char TestFixture::char_of(uint16_t keycode) {
+    if (keycode >= KC_A && keycode <= KC_Z) {
+        return 'a' + keycode - KC_A;
+    }
+    if (keycode >= KC_1 && keycode <= KC_9) {
+        return '1' + keycode - KC_1;
+    }
+    switch (keycode) {
+    case KC_0: return '0';
+    case KC_SPC: return ' ';
+    case KC_COMM: return ',';
+    case KC_DOT: return '.';
+    }
+    return '?';
+}
+
+std::string TestFixture::typed() const {
+    std::string text;
+    report_keyboard_t previous = {};
+    for (const report_keyboard_t& report : reports) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            uint8_t key = report.keys[i];
+            bool is_new = key != 0;
+            for (uint8_t j = 0; j < KEYBOARD_REPORT_KEYS && is_new; j++) {
+                is_new = previous.keys[j] != key;
+            }
+            if (is_new) {
+                char c = char_of(key);
+                text += report.mods & MOD_BIT(KC_LSFT) ? toupper(c) : c;
+            }
+        }
+        previous = report;
+    }
+    return text;
+}
@@ -17,6 +17,11 @@
  #pragma once
 
 #include "gtest/gtest.h"
+#include "report.h"
+#include <string>
+#include <vector>
+
+class TestDriver;
 
 class TestFixture : public testing::Test {
 public:
@@ -27,4 +32,14 @@ public:
 
     void run_one_scan_loop();
     void idle_for(unsigned ms);
+
+protected:
+    // Records every keyboard report the driver sends into reports
+    void record(TestDriver& driver);
+    std::vector<report_keyboard_t> reports;
+    // The keys as the host sees them being pressed in the recorded reports,
+    // upper case when shifted
+    std::string typed() const;
+    // The character of a letter, digit, space, comma or dot keycode, or '?'
+    static char char_of(uint16_t keycode);
 };
\ No newline at end of file
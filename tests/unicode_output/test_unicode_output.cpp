@@ -0,0 +1,159 @@
+/* Copyright 2017 QMK Firmware contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+    void advance_time(uint32_t ms);
+}
+
+class UnicodeOutput : public TestFixture {
+protected:
+    void tap_key(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(UnicodeOutput, MeasuresReportsPerCodePoint) {
+    const uint8_t modes[] = {UC_LNX, UC_OSX, UC_WINC};
+    const char *const names[] = {"UC_LNX", "UC_OSX", "UC_WINC"};
+    for (uint8_t m = 0; m < 3; m++) {
+        TestDriver driver;
+        record(driver);
+        set_unicode_input_mode(modes[m]);
+
+        reports.clear();
+        for (uint8_t i = 0; i < 4; i++) {
+            tap_key(i % 2);
+        }
+        size_t keycode_reports = reports.size();
+
+        reports.clear();
+        send_unicode_string("\xC3\xA9\xE2\x80\x94\xC3\xA9\xE2\x80\x94");
+        size_t string_reports = reports.size();
+
+        EXPECT_LT(string_reports, keycode_reports) << names[m];
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+}
+
+TEST_F(UnicodeOutput, TypesTheHexSequence) {
+    TestDriver driver;
+    record(driver);
+    set_unicode_input_mode(UC_LNX);
+    send_unicode_string("\xC3\xA9" "a");
+    // The prefix is Ctrl+Shift+U, so it shows as upper case
+    EXPECT_EQ(typed(), "U00e9 U0061 ");
+    EXPECT_TRUE(KeyboardReport().Matches(reports.back()));
+    EXPECT_FALSE(unicode_output_busy());
+
+    reports.clear();
+    set_unicode_input_mode(UC_WINC);
+    send_unicode_string("\xE2\x80\x94");
+    EXPECT_EQ(typed(), "u2014");
+    // The compose key is tapped before the sequence
+    EXPECT_TRUE(KeyboardReport(KC_RALT).Matches(reports[0])) << reports[0];
+}
+
+TEST_F(UnicodeOutput, ModsAreRestoredOnceAtTheEnd) {
+    TestDriver driver;
+    record(driver);
+    set_unicode_input_mode(UC_OSX);
+    press_key(2, 0);
+    run_one_scan_loop();
+    reports.clear();
+    send_unicode_string("\xC3\xA9\xC3\xA9");
+    ASSERT_GE(reports.size(), 2u);
+    for (size_t i = 0; i + 1 < reports.size(); i++) {
+        EXPECT_FALSE(reports[i].mods & MOD_BIT(KC_LSFT)) << "report " << i << reports[i];
+    }
+    EXPECT_TRUE(KeyboardReport(KC_LSFT).Matches(reports.back())) << reports.back();
+    EXPECT_EQ(get_mods(), MOD_BIT(KC_LSFT));
+    release_key(2, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(UnicodeOutput, InvalidUtf8IsTypedAsReplacementCharacter) {
+    TestDriver driver;
+    record(driver);
+    set_unicode_input_mode(UC_LNX);
+    send_unicode_string("\xFF" "\xC3");
+    EXPECT_EQ(typed(), "Ufffd Ufffd ");
+}
+
+TEST_F(UnicodeOutput, SupplementaryCodePointsUseSurrogatesOnOSX) {
+    TestDriver driver;
+    record(driver);
+    set_unicode_input_mode(UC_OSX);
+    send_unicode_string("\xF0\x9F\x98\x80");
+    EXPECT_EQ(typed(), "d83dde00");
+
+    reports.clear();
+    set_unicode_input_mode(UC_WINC);
+    send_unicode_string("\xF0\x9F\x98\x80");
+    EXPECT_EQ(typed(), "u1f600");
+}
+
+TEST_F(UnicodeOutput, CodePointsTheModeCantTypeAreTypedAsReplacementCharacter) {
+    TestDriver driver;
+    record(driver);
+    set_unicode_input_mode(UC_LNX);
+    send_unicode_string("\xF4\x8F\xBF\xBF");
+    EXPECT_EQ(typed(), "U10ffff ");
+
+    // Alt and the numpad only take four hex digits
+    reports.clear();
+    set_unicode_input_mode(UC_WIN);
+    send_unicode_string("\xF0\x9F\x98\x80" "\xE2\x80\x94");
+    EXPECT_EQ(typed(), "?fffd?2014");
+}
+
+TEST_F(UnicodeOutput, AsyncStringIsTypedAcrossScans) {
+    TestDriver driver;
+    record(driver);
+    set_unicode_input_mode(UC_LNX);
+    EXPECT_TRUE(send_unicode_string_async_P(PSTR("\xC3\xA9\xE2\x80\x94")));
+    EXPECT_FALSE(send_unicode_string_async("a"));
+
+    // The prefix, then nothing until the input method is ready
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "U");
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "U");
+
+    // A key pressed in the meantime waits for the code point to be finished,
+    // instead of changing it
+    press_key(3, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "U");
+    advance_time(UNICODE_TYPE_DELAY);
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "U00e9 a");
+    EXPECT_TRUE(unicode_output_busy());
+
+    // So does its release, after the next code point is started
+    release_key(3, 0);
+    run_one_scan_loop();
+    EXPECT_TRUE(KeyboardReport(KC_A).Matches(reports.back())) << reports.back();
+    advance_time(UNICODE_TYPE_DELAY);
+    run_one_scan_loop();
+    EXPECT_EQ(typed(), "U00e9 aU2014 ");
+    EXPECT_FALSE(unicode_output_busy());
+    EXPECT_TRUE(KeyboardReport().Matches(reports.back())) << reports.back();
+}
@@ -127,6 +127,16 @@ ifeq ($(strip $(ONEHAND_ENABLE)), yes)
     TMK_COMMON_DEFS += -DONEHAND_ENABLE
 endif
 
+ifeq ($(strip $(KEYEVENT_QUEUE_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/keyevent_queue.c
+    TMK_COMMON_DEFS += -DKEYEVENT_QUEUE_ENABLE
+endif
+
+ifeq ($(strip $(SCAN_PROFILE_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/scan_profile.c
+    TMK_COMMON_DEFS += -DSCAN_PROFILE_ENABLE
+endif
+
 ifeq ($(strip $(NO_USB_STARTUP_CHECK)), yes)
     TMK_COMMON_DEFS += -DNO_USB_STARTUP_CHECK
 endif
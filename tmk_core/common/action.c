@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_util.h"
 #include "action.h"
 #include "wait.h"
+#include "scan_profile.h"
 
 #ifdef DEBUG_ACTION
 #include "debug.h"
@@ -46,6 +47,7 @@ int retro_tapping_counter = 0;
 
 void action_exec(keyevent_t event)
 {
+    SCAN_PROFILE_BEGIN(ACTION_EXEC);
     if (!IS_NOEVENT(event)) {
         dprint("\n---- action_exec: start -----\n");
         dprint("EVENT: "); debug_event(event); dprintln();
@@ -89,6 +91,7 @@ void action_exec(keyevent_t event)
         dprint("processed: "); debug_record(record); dprintln();
     }
 #endif
+    SCAN_PROFILE_END(ACTION_EXEC);
 }
 
 #ifdef ONEHAND_ENABLE
@@ -136,7 +139,10 @@ void process_record(keyrecord_t *record)
 {
     if (IS_NOEVENT(record->event)) { return; }
 
-    if(!process_record_quantum(record))
+    SCAN_PROFILE_BEGIN(PROCESS_RECORD);
+    bool handled = !process_record_quantum(record);
+    SCAN_PROFILE_END(PROCESS_RECORD);
+    if (handled)
         return;
 
     action_t action = store_or_get_action(record->event.pressed, record->event.key);
@@ -1,5 +1,7 @@
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
+#include "matrix.h"
 #include "action.h"
 #include "util.h"
 #include "action_layer.h"
@@ -162,6 +164,70 @@ uint8_t read_source_layers_cache(keypos_t key)
 }
 #endif
 
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_ACTION_CACHE)
+/*
+ * Resolved layer and action of every key, valid for the layer state they
+ * were looked up with. Saves walking all active layers on every event.
+ */
+static uint32_t layer_action_cache_state = 0;
+static matrix_row_t layer_action_cache_valid[MATRIX_ROWS];
+static int8_t layer_action_cache_layer[MATRIX_ROWS][MATRIX_COLS];
+static action_t layer_action_cache_action[MATRIX_ROWS][MATRIX_COLS];
+
+void layer_action_cache_clear(void)
+{
+    memset(layer_action_cache_valid, 0, sizeof(layer_action_cache_valid));
+}
+#endif
+
+/* finds the topmost layer with a non-transparent action for the key */
+static int8_t layer_switch_resolve(keypos_t key, action_t *action)
+{
+#ifndef NO_ACTION_LAYER
+    uint32_t layers = layer_state | default_layer_state;
+#ifdef LAYER_ACTION_CACHE
+    bool cacheable = key.row < MATRIX_ROWS && key.col < MATRIX_COLS;
+    matrix_row_t col_bit = (matrix_row_t)1 << key.col;
+    if (cacheable) {
+        if (layers != layer_action_cache_state) {
+            layer_action_cache_clear();
+            layer_action_cache_state = layers;
+        } else if (layer_action_cache_valid[key.row] & col_bit) {
+            *action = layer_action_cache_action[key.row][key.col];
+            return layer_action_cache_layer[key.row][key.col];
+        }
+    }
+#endif
+
+    int8_t layer = 0;
+    /* check top layer first */
+    for (int8_t i = 31; i >= 0; i--) {
+        if (layers & (1UL<<i)) {
+            *action = action_for_key(i, key);
+            if (action->code != ACTION_TRANSPARENT) {
+                layer = i;
+                goto FOUND;
+            }
+        }
+    }
+    /* fall back to layer 0 */
+    *action = action_for_key(0, key);
+FOUND:
+#ifdef LAYER_ACTION_CACHE
+    if (cacheable) {
+        layer_action_cache_layer[key.row][key.col] = layer;
+        layer_action_cache_action[key.row][key.col] = *action;
+        layer_action_cache_valid[key.row] |= col_bit;
+    }
+#endif
+    return layer;
+#else
+    int8_t layer = biton32(default_layer_state);
+    *action = action_for_key(layer, key);
+    return layer;
+#endif
+}
+
 /*
  * Make sure the action triggered when the key is released is the same
  * one as the one triggered on press. It's important for the mod keys
@@ -178,8 +244,10 @@ action_t store_or_get_action(bool pressed, keypos_t key)
     uint8_t layer;
 
     if (pressed) {
-        layer = layer_switch_get_layer(key);
+        action_t action;
+        layer = layer_switch_resolve(key, &action);
         update_source_layers_cache(key, layer);
+        return action;
     }
     else {
         layer = read_source_layers_cache(key);
@@ -193,28 +261,13 @@ action_t store_or_get_action(bool pressed, keypos_t key)
 
 int8_t layer_switch_get_layer(keypos_t key)
 {
-#ifndef NO_ACTION_LAYER
     action_t action;
-    action.code = ACTION_TRANSPARENT;
-
-    uint32_t layers = layer_state | default_layer_state;
-    /* check top layer first */
-    for (int8_t i = 31; i >= 0; i--) {
-        if (layers & (1UL<<i)) {
-            action = action_for_key(i, key);
-            if (action.code != ACTION_TRANSPARENT) {
-                return i;
-            }
-        }
-    }
-    /* fall back to layer 0 */
-    return 0;
-#else
-    return biton32(default_layer_state);
-#endif
+    return layer_switch_resolve(key, &action);
 }
 
 action_t layer_switch_get_action(keypos_t key)
 {
-    return action_for_key(layer_switch_get_layer(key), key);
+    action_t action;
+    layer_switch_resolve(key, &action);
+    return action;
 }
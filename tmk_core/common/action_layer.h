@@ -21,6 +21,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "keyboard.h"
 #include "action.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /*
  * Default Layer
@@ -85,6 +88,12 @@ uint32_t layer_state_set_kb(uint32_t state);
 void update_source_layers_cache(keypos_t key, uint8_t layer);
 uint8_t read_source_layers_cache(keypos_t key);
 #endif
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_ACTION_CACHE)
+/* call when the keymap changes at runtime, layer changes are detected */
+void layer_action_cache_clear(void);
+#else
+#define layer_action_cache_clear()
+#endif
 action_t store_or_get_action(bool pressed, keypos_t key);
 
 /* return the topmost non-transparent layer currently associated with key */
@@ -93,4 +102,8 @@ int8_t layer_switch_get_layer(keypos_t key);
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -18,16 +18,29 @@
 #define IS_TAPPING_PRESSED()    (IS_TAPPING() && tapping_key.event.pressed)
 #define IS_TAPPING_RELEASED()   (IS_TAPPING() && !tapping_key.event.pressed)
 #define IS_TAPPING_KEY(k)       (IS_TAPPING() && KEYEQ(tapping_key.event.key, (k)))
-#define WITHIN_TAPPING_TERM(e)  (TIMER_DIFF_16(e.time, tapping_key.event.time) < TAPPING_TERM)
+#ifdef TAPPING_TERM_PER_KEY
+#define GET_TAPPING_TERM()      get_tapping_term(tapping_key.event.key)
+#else
+#define GET_TAPPING_TERM()      TAPPING_TERM
+#endif
+#define WITHIN_TAPPING_TERM(e)  (TIMER_DIFF_16(e.time, tapping_key.event.time) < GET_TAPPING_TERM())
+#ifdef PERMISSIVE_HOLD
+#define IS_PERMISSIVE_HOLD()    true
+#else
+#define IS_PERMISSIVE_HOLD()    (GET_TAPPING_TERM() >= 500)
+#endif
 
 
 static keyrecord_t tapping_key = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t waiting_buffer_head = 0;
 static uint8_t waiting_buffer_tail = 0;
+static uint16_t waiting_buffer_overflows = 0;
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_process(void);
+static bool waiting_buffer_spill(void);
 static void waiting_buffer_clear(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
@@ -44,11 +57,14 @@ void action_tapping_process(keyrecord_t record)
         }
     } else {
         if (!waiting_buffer_enq(record)) {
-            // clear all in case of overflow.
-            debug("OVERFLOW: CLEAR ALL STATES\n");
-            clear_keyboard();
-            waiting_buffer_clear();
-            tapping_key = (keyrecord_t){};
+            waiting_buffer_overflows++;
+            // make room by settling the tapping key, or clear all if that doesn't help.
+            if (!waiting_buffer_spill() || !waiting_buffer_enq(record)) {
+                debug("OVERFLOW: CLEAR ALL STATES\n");
+                clear_keyboard();
+                waiting_buffer_clear();
+                tapping_key = (keyrecord_t){};
+            }
         }
     }
 
@@ -56,19 +72,25 @@ void action_tapping_process(keyrecord_t record)
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
-            debug("processed: waiting_buffer["); debug_dec(waiting_buffer_tail); debug("] = ");
-            debug_record(waiting_buffer[waiting_buffer_tail]); debug("\n\n");
-        } else {
-            break;
-        }
-    }
+    waiting_buffer_process();
     if (!IS_NOEVENT(record.event)) {
         debug("\n");
     }
 }
 
+#ifdef TAPPING_TERM_PER_KEY
+__attribute__ ((weak))
+uint16_t get_tapping_term(keypos_t key)
+{
+    return TAPPING_TERM;
+}
+#endif
+
+uint16_t action_tapping_overflows(void)
+{
+    return waiting_buffer_overflows;
+}
+
 
 /* Tapping
  *
@@ -96,12 +118,11 @@ bool process_tapping(keyrecord_t *keyp)
                     // enqueue
                     return false;
                 }
-#if TAPPING_TERM >= 500 || defined PERMISSIVE_HOLD
                 /* Process a key typed within TAPPING_TERM
                  * This can register the key before settlement of tapping,
                  * useful for long TAPPING_TERM but may prevent fast typing.
                  */
-                else if (IS_RELEASED(event) && waiting_buffer_typed(event)) {
+                else if (IS_PERMISSIVE_HOLD() && IS_RELEASED(event) && waiting_buffer_typed(event)) {
                     debug("Tapping: End. No tap. Interfered by typing key\n");
                     process_record(&tapping_key);
                     tapping_key = (keyrecord_t){};
@@ -109,7 +130,6 @@ bool process_tapping(keyrecord_t *keyp)
                     // enqueue
                     return false;
                 }
-#endif
                 /* Process release event of a key pressed before tapping starts
                  * Without this unexpected repeating will occur with having fast repeating setting
                  * https://github.com/tmk/tmk_keyboard/issues/60
@@ -309,6 +329,37 @@ bool waiting_buffer_enq(keyrecord_t record)
     return true;
 }
 
+void waiting_buffer_process(void)
+{
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+            debug("processed: waiting_buffer["); debug_dec(waiting_buffer_tail); debug("] = ");
+            debug_record(waiting_buffer[waiting_buffer_tail]); debug("\n\n");
+        } else {
+            break;
+        }
+    }
+}
+
+/* The buffer only fills up while a tap key is held and other keys are typed,
+ * so settle it as held, as if TAPPING_TERM had passed, and process what was
+ * waiting for it. Returns false when there is no such tap key.
+ * A tap key released inside TAPPING_TERM after this acts as held, so a fast
+ * roll over it becomes its modifier instead of dropping keys.
+ */
+bool waiting_buffer_spill(void)
+{
+    if (!IS_TAPPING_PRESSED() || tapping_key.tap.count > 0) {
+        return false;
+    }
+    debug("waiting_buffer: Over flow. Tapping: End. Not tap(0).\n");
+    process_record(&tapping_key);
+    tapping_key = (keyrecord_t){};
+    debug_tapping_key();
+    waiting_buffer_process();
+    return true;
+}
+
 void waiting_buffer_clear(void)
 {
     waiting_buffer_head = 0;
@@ -31,11 +31,33 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define TAPPING_TOGGLE  5
 #endif
 
+/* events that can wait for a tap key to be settled, one less than the size */
+#ifndef WAITING_BUFFER_SIZE
 #define WAITING_BUFFER_SIZE 8
+#endif
+
+#if WAITING_BUFFER_SIZE > 128
+#error "WAITING_BUFFER_SIZE can be at most 128"
+#endif
+
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 #ifndef NO_ACTION_TAPPING
 void action_tapping_process(keyrecord_t record);
+#ifdef TAPPING_TERM_PER_KEY
+/* tapping term of the tap key at this position, looked up on every event
+ * while it is being settled, so it should be a table lookup or a switch */
+uint16_t get_tapping_term(keypos_t key);
+#endif
+/* how many times the waiting buffer was full */
+uint16_t action_tapping_overflows(void);
+#endif
+
+#ifdef __cplusplus
+}
 #endif
 
 #endif
@@ -27,7 +27,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "keyboard.h"
 #include "bootloader.h"
 #include "action_layer.h"
+#include "scan_profile.h"
 #include "action_util.h"
+#include "action_tapping.h"
 #include "eeconfig.h"
 #include "sleep_led.h"
 #include "led.h"
@@ -170,6 +172,10 @@ static void command_common_help(void)
 #ifdef SLEEP_LED_ENABLE
 		STR(MAGIC_KEY_SLEEP_LED   ) ":	Sleep LED Test\n"
 #endif
+
+#ifdef SCAN_PROFILE_ENABLE
+		STR(MAGIC_KEY_SCAN_PROFILE) ":	Print and Reset Scan Profile\n"
+#endif
     );
 }
 
@@ -244,6 +250,9 @@ static void print_status(void)
     print_val_hex8(keymap_config.nkro);
 #endif
     print_val_hex32(timer_read32());
+#ifndef NO_ACTION_TAPPING
+    print("tapping overflows: "); print_dec(action_tapping_overflows()); print("\n");
+#endif
 
 #ifdef PROTOCOL_PJRC
     print_val_hex8(UDCON);
@@ -322,6 +331,15 @@ static bool command_common(uint8_t code)
             break;
 #endif
 
+#ifdef SCAN_PROFILE_ENABLE
+
+		// print the time taken by each stage of the scan
+        case MAGIC_KC(MAGIC_KEY_SCAN_PROFILE):
+            scan_profile_print();
+            scan_profile_reset();
+            break;
+#endif
+
 #ifdef BOOTMAGIC_ENABLE
 
 		// print stored eeprom config
@@ -146,6 +146,10 @@ bool command_proc(uint8_t code);
 #define MAGIC_KEY_NKRO           N
 #endif
 
+#ifndef MAGIC_KEY_SCAN_PROFILE
+#define MAGIC_KEY_SCAN_PROFILE   P
+#endif
+
 #ifndef MAGIC_KEY_SLEEP_LED
 #define MAGIC_KEY_SLEEP_LED      Z
 
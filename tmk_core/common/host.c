@@ -16,20 +16,31 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 //#include <avr/interrupt.h>
 #include "keycode.h"
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "scan_profile.h"
 
 static host_driver_t *driver;
 static uint16_t last_system_report = 0;
 static uint16_t last_consumer_report = 0;
+static report_keyboard_t last_keyboard_report;
+static bool keyboard_report_sent = false;
+static bool keyboard_report_dropped;
+#ifdef KEYBOARD_REPORT_BATCH
+static report_keyboard_t pending_keyboard_report;
+static bool keyboard_report_pending = false;
+#endif
 
 
 void host_set_driver(host_driver_t *d)
 {
     driver = d;
+    // the new host hasn't seen anything yet
+    keyboard_report_sent = false;
 }
 
 host_driver_t *host_get_driver(void)
@@ -43,10 +54,19 @@ uint8_t host_keyboard_leds(void)
     return (*driver->keyboard_leds)();
 }
 /* send report */
-void host_keyboard_send(report_keyboard_t *report)
+static void keyboard_send(report_keyboard_t *report)
 {
     if (!driver) return;
+    if (keyboard_report_sent && !memcmp(report, &last_keyboard_report, sizeof(report_keyboard_t))) return;
+
+    keyboard_report_dropped = false;
+    SCAN_PROFILE_BEGIN(USB_SEND);
     (*driver->send_keyboard)(report);
+    SCAN_PROFILE_END(USB_SEND);
+    // only what the host got, so that a dropped report is sent again
+    if (keyboard_report_dropped) return;
+    last_keyboard_report = *report;
+    keyboard_report_sent = true;
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -57,6 +77,35 @@ void host_keyboard_send(report_keyboard_t *report)
     }
 }
 
+void host_keyboard_send(report_keyboard_t *report)
+{
+#ifdef KEYBOARD_REPORT_BATCH
+    if (keyboard_report_pending &&
+        !can_replace_report(keyboard_report_sent ? &last_keyboard_report : NULL, &pending_keyboard_report, report)) {
+        host_keyboard_flush();
+    }
+    pending_keyboard_report = *report;
+    keyboard_report_pending = true;
+#else
+    keyboard_send(report);
+#endif
+}
+
+void host_keyboard_dropped(void)
+{
+    keyboard_report_dropped = true;
+}
+
+void host_keyboard_flush(void)
+{
+#ifdef KEYBOARD_REPORT_BATCH
+    if (keyboard_report_pending) {
+        keyboard_report_pending = false;
+        keyboard_send(&pending_keyboard_report);
+    }
+#endif
+}
+
 void host_mouse_send(report_mouse_t *report)
 {
     if (!driver) return;
@@ -38,7 +38,12 @@ host_driver_t *host_get_driver(void);
 
 /* host driver interface */
 uint8_t host_keyboard_leds(void);
+/* reports that are the same as the last one are not sent again */
 void host_keyboard_send(report_keyboard_t *report);
+/* with KEYBOARD_REPORT_BATCH, sends the report held back by host_keyboard_send */
+void host_keyboard_flush(void);
+/* called by a driver that couldn't send the keyboard report it was given */
+void host_keyboard_dropped(void);
 void host_mouse_send(report_mouse_t *report);
 void host_system_send(uint16_t data);
 void host_consumer_send(uint16_t data);
@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "eeconfig.h"
 #include "backlight.h"
 #include "action_layer.h"
+#include "scan_profile.h"
 #ifdef BOOTMAGIC_ENABLE
 #   include "bootmagic.h"
 #else
@@ -54,9 +55,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef STENO_ENABLE
 #   include "process_steno.h"
 #endif
+#ifdef KEYEVENT_QUEUE_ENABLE
+#   include "keyevent_queue.h"
+#endif
 #ifdef FAUXCLICKY_ENABLE
 #   include "fauxclicky.h"
 #endif
+#ifdef SEND_STRING_ASYNC_ENABLE
+#   include "send_string_async.h"
+#endif
+#ifdef UNICODE_COMMON_ENABLE
+#   include "process_unicode_common.h"
+#endif
 #ifdef SERIAL_LINK_ENABLE
 #   include "serial_link/system/serial_link.h"
 #endif
@@ -127,9 +137,23 @@ bool is_keyboard_master(void) {
     return true;
 }
 
+/* Matrix implementations that don't track changed rows report every row as
+ * changed, which makes keyboard_task fall back to diffing the whole matrix.
+ */
+__attribute__((weak))
+matrix_changed_t matrix_changed_rows(void) {
+    return MATRIX_CHANGED_ALL;
+}
+
 void keyboard_init(void) {
     timer_init();
+#ifdef SCAN_PROFILE_ENABLE
+    scan_profile_init();
+#endif
     matrix_init();
+#ifdef KEYEVENT_QUEUE_ENABLE
+    keyevent_queue_clear();
+#endif
 #ifdef PS2_MOUSE_ENABLE
     ps2_mouse_init();
 #endif
@@ -162,78 +186,200 @@ void keyboard_init(void) {
 #if defined(NKRO_ENABLE) && defined(FORCE_NKRO)
     keymap_config.nkro = 1;
 #endif
+#ifdef KEYBOARD_REPORT_BATCH
+    host_keyboard_flush();
+#endif
 }
 
+#if defined(KEYEVENT_SCAN_THREAD) && !defined(KEYEVENT_QUEUE_ENABLE)
+#   error "KEYEVENT_SCAN_THREAD needs KEYEVENT_QUEUE_ENABLE = yes"
+#endif
+#if defined(KEYEVENT_SCAN_THREAD) && !defined(PROTOCOL_CHIBIOS)
+#   error "KEYEVENT_SCAN_THREAD is only supported on ChibiOS"
+#endif
+#if defined(KEYEVENT_SCAN_THREAD) && !defined(QUANTUM_MATRIX)
+#   error "KEYEVENT_SCAN_THREAD needs the quantum matrix, a custom matrix_scan() runs the matrix_scan_* hooks in the scan thread"
+#endif
+
+#ifdef QMK_KEYS_PER_SCAN
+#   define KEYS_PER_SCAN QMK_KEYS_PER_SCAN
+#else
+#   define KEYS_PER_SCAN 1
+#endif
+
+static matrix_row_t matrix_prev[MATRIX_ROWS];
+// rows which may still differ from matrix_prev, all of them at startup
+// since bootmagic may already have consumed the first scan
+static matrix_changed_t matrix_dirty = MATRIX_CHANGED_ALL;
+
 /*
- * Do keyboard routine jobs: scan mantrix, light LEDs, ...
- * This is repeatedly called as fast as possible.
+ * Whether the key events have to wait, while a unicode code point is open in
+ * the input method. Without KEYEVENT_QUEUE_ENABLE they wait in the matrix,
+ * so a key that is pressed and released in the meantime is lost.
  */
-void keyboard_task(void)
+static bool key_events_held(void)
+{
+#ifdef UNICODE_COMMON_ENABLE
+    return unicode_output_holds_keys();
+#else
+    return false;
+#endif
+}
+
+/*
+ * Scans the matrix and turns at most max_keys changed keys into events,
+ * stamped with the current time. The events are executed right away, or
+ * queued with KEYEVENT_QUEUE_ENABLE. Returns the number of events.
+ */
+static uint8_t matrix_scan_events(uint8_t max_keys)
 {
-    static matrix_row_t matrix_prev[MATRIX_ROWS];
 #ifdef MATRIX_HAS_GHOST
   //  static matrix_row_t matrix_ghost[MATRIX_ROWS];
 #endif
-    static uint8_t led_status = 0;
     matrix_row_t matrix_row = 0;
     matrix_row_t matrix_change = 0;
-#ifdef QMK_KEYS_PER_SCAN
     uint8_t keys_processed = 0;
-#endif
 
+    SCAN_PROFILE_BEGIN(MATRIX_SCAN);
     matrix_scan();
-    if (is_keyboard_master()) {
-        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
-            matrix_row = matrix_get_row(r);
-            matrix_change = matrix_row ^ matrix_prev[r];
-            if (matrix_change) {
+    SCAN_PROFILE_END(MATRIX_SCAN);
+    matrix_dirty |= matrix_changed_rows();
+    if (!is_keyboard_master() || !matrix_dirty) {
+        return 0;
+    }
+#ifndef KEYEVENT_QUEUE_ENABLE
+    if (key_events_held()) {
+        return 0;
+    }
+#endif
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        if (!(matrix_dirty & ((matrix_changed_t)1<<r))) {
+            continue;
+        }
+        matrix_row = matrix_get_row(r);
+        matrix_change = matrix_row ^ matrix_prev[r];
+        if (!matrix_change) {
+            matrix_dirty &= ~((matrix_changed_t)1<<r);
+            continue;
+        }
 #ifdef MATRIX_HAS_GHOST
-                if (has_ghost_in_row(r, matrix_row)) {
-                    /* Keep track of whether ghosted status has changed for
-                    * debugging. But don't update matrix_prev until un-ghosted, or
-                    * the last key would be lost.
-                    */
-                    //if (debug_matrix && matrix_ghost[r] != matrix_row) {
-                    //    matrix_print();
-                    //}
-                    //matrix_ghost[r] = matrix_row;
-                    continue;
+        if (has_ghost_in_row(r, matrix_row)) {
+            /* Keep track of whether ghosted status has changed for
+            * debugging. But don't update matrix_prev until un-ghosted, or
+            * the last key would be lost.
+            */
+            //if (debug_matrix && matrix_ghost[r] != matrix_row) {
+            //    matrix_print();
+            //}
+            //matrix_ghost[r] = matrix_row;
+            continue;
+        }
+        //matrix_ghost[r] = matrix_row;
+#endif
+        if (debug_matrix) matrix_print();
+        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+            if (matrix_change & ((matrix_row_t)1<<c)) {
+                keyevent_t event = {
+                    .key = (keypos_t){ .row = r, .col = c },
+                    .pressed = (matrix_row & ((matrix_row_t)1<<c)),
+                    .time = (timer_read() | 1) /* time should not be 0 */
+                };
+#ifdef KEYEVENT_QUEUE_ENABLE
+                // when full, the key stays unprocessed and is queued on a later scan
+                if (!keyevent_queue_push(event)) {
+                    return keys_processed;
                 }
-                //matrix_ghost[r] = matrix_row;
-#endif
-                if (debug_matrix) matrix_print();
-                for (uint8_t c = 0; c < MATRIX_COLS; c++) {
-                    if (matrix_change & ((matrix_row_t)1<<c)) {
-                        action_exec((keyevent_t){
-                            .key = (keypos_t){ .row = r, .col = c },
-                            .pressed = (matrix_row & ((matrix_row_t)1<<c)),
-                            .time = (timer_read() | 1) /* time should not be 0 */
-                        });
-                        // record a processed key
-                        matrix_prev[r] ^= ((matrix_row_t)1<<c);
-#ifdef QMK_KEYS_PER_SCAN
-                        // only jump out if we have processed "enough" keys.
-                        if (++keys_processed >= QMK_KEYS_PER_SCAN)
+#else
+                action_exec(event);
 #endif
-                        // process a key per task call
-                        goto MATRIX_LOOP_END;
-                    }
+                // record a processed key
+                matrix_prev[r] ^= ((matrix_row_t)1<<c);
+                if (matrix_prev[r] == matrix_row) {
+                    matrix_dirty &= ~((matrix_changed_t)1<<r);
+                }
+                if (++keys_processed >= max_keys) {
+                    return keys_processed;
                 }
             }
         }
     }
+    return keys_processed;
+}
+
+#ifdef KEYEVENT_QUEUE_ENABLE
+/*
+ * The producer half of keyboard_task: queues the changed keys. Runs in its
+ * own thread with KEYEVENT_SCAN_THREAD.
+ */
+void keyboard_scan_task(void)
+{
+    matrix_scan_events(UINT8_MAX);
+}
+
+/*
+ * The consumer half of keyboard_task: executes the queued events, or a tick
+ * when there are none.
+ */
+void keyboard_process_task(void)
+{
+    keyevent_t event;
+    uint8_t keys_processed = 0;
+
+#ifdef KEYEVENT_SCAN_THREAD
+    // the hooks share their state with action_exec, so they stay in this
+    // thread, and the scan thread only reads the matrix
+    matrix_scan_quantum();
+#endif
+
+    if (key_events_held()) {
+        return;
+    }
+    while (keys_processed < KEYS_PER_SCAN && keyevent_queue_pop(&event)) {
+        action_exec(event);
+        keys_processed++;
+    }
+    if (!keys_processed) {
+        action_exec(TICK);
+    }
+}
+#endif
+
+/*
+ * Do keyboard routine jobs: scan mantrix, light LEDs, ...
+ * This is repeatedly called as fast as possible.
+ */
+void keyboard_task(void)
+{
+    static uint8_t led_status = 0;
+    SCAN_PROFILE_BEGIN(KEYBOARD_TASK);
+
+#ifdef KEYEVENT_QUEUE_ENABLE
+#   ifndef KEYEVENT_SCAN_THREAD
+    keyboard_scan_task();
+#   endif
+    keyboard_process_task();
+#else
     // call with pseudo tick event when no real key event.
-#ifdef QMK_KEYS_PER_SCAN
-    // we can get here with some keys processed now.
-    if (!keys_processed)
+    if (!matrix_scan_events(KEYS_PER_SCAN) && !key_events_held()) {
+        action_exec(TICK);
+    }
+#endif
+
+#ifdef SEND_STRING_ASYNC_ENABLE
+    send_string_async_task();
+#endif
+
+#ifdef KEYBOARD_REPORT_BATCH
+    // one report for all the keys of this scan
+    host_keyboard_flush();
 #endif
-    action_exec(TICK);
 
-MATRIX_LOOP_END:
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
+    SCAN_PROFILE_BEGIN(MOUSEKEY);
     mousekey_task();
+    SCAN_PROFILE_END(MOUSEKEY);
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
@@ -253,7 +399,9 @@ MATRIX_LOOP_END:
 #endif
 
 #ifdef VISUALIZER_ENABLE
+    SCAN_PROFILE_BEGIN(VISUALIZER);
     visualizer_update(default_layer_state, layer_state, visualizer_get_mods(), host_keyboard_leds());
+    SCAN_PROFILE_END(VISUALIZER);
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
@@ -265,6 +413,7 @@ MATRIX_LOOP_END:
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+    SCAN_PROFILE_END(KEYBOARD_TASK);
 }
 
 void keyboard_set_leds(uint8_t leds)
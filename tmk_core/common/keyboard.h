@@ -63,6 +63,9 @@ void keyboard_setup(void);
 void keyboard_init(void);
 /* it runs repeatedly in main loop */
 void keyboard_task(void);
+/* the scan and process halves of keyboard_task, with KEYEVENT_QUEUE_ENABLE */
+void keyboard_scan_task(void);
+void keyboard_process_task(void);
 /* it runs when host LED status is updated */
 void keyboard_set_leds(uint8_t leds);
 
@@ -0,0 +1,59 @@
+/*
+Copyright 2017 QMK Firmware contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "keyevent_queue.h"
+
+/* Keeps the compiler from moving the event copy past the index update */
+#define QUEUE_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+static keyevent_t queue[KEYEVENT_QUEUE_SIZE];
+/* Free running, the slot is the index modulo the size */
+static volatile uint8_t head;
+static volatile uint8_t tail;
+
+bool keyevent_queue_push(keyevent_t event)
+{
+    uint8_t h = head;
+    if ((uint8_t)(h - tail) >= KEYEVENT_QUEUE_SIZE) {
+        return false;
+    }
+    queue[h & (KEYEVENT_QUEUE_SIZE - 1)] = event;
+    QUEUE_BARRIER();
+    head = h + 1;
+    return true;
+}
+
+bool keyevent_queue_pop(keyevent_t *event)
+{
+    uint8_t t = tail;
+    if (t == head) {
+        return false;
+    }
+    *event = queue[t & (KEYEVENT_QUEUE_SIZE - 1)];
+    QUEUE_BARRIER();
+    tail = t + 1;
+    return true;
+}
+
+uint8_t keyevent_queue_count(void)
+{
+    return head - tail;
+}
+
+void keyevent_queue_clear(void)
+{
+    head = tail = 0;
+}
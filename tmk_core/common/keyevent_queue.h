@@ -0,0 +1,55 @@
+/*
+Copyright 2017 QMK Firmware contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef KEYEVENT_QUEUE_H
+#define KEYEVENT_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "keyboard.h"
+
+/*
+ * Single producer, single consumer queue of key events, between the matrix
+ * scan and the action processing. The producer only writes the head and the
+ * consumer only writes the tail, so no locking is needed as long as there is
+ * only one of each.
+ */
+
+#ifndef KEYEVENT_QUEUE_SIZE
+#define KEYEVENT_QUEUE_SIZE 16
+#endif
+
+#if KEYEVENT_QUEUE_SIZE > 128 || (KEYEVENT_QUEUE_SIZE & (KEYEVENT_QUEUE_SIZE - 1)) != 0
+#error "KEYEVENT_QUEUE_SIZE must be a power of two, at most 128"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Producer side, returns false when the queue is full */
+bool keyevent_queue_push(keyevent_t event);
+/* Consumer side, returns false when the queue is empty */
+bool keyevent_queue_pop(keyevent_t *event);
+uint8_t keyevent_queue_count(void);
+/* Only when neither side is running */
+void keyevent_queue_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -31,6 +31,19 @@ typedef  uint32_t   matrix_row_t;
 #error "MATRIX_COLS: invalid value"
 #endif
 
+/* bitmap with one bit per row, see matrix_changed_rows() */
+#if (MATRIX_ROWS <= 8)
+typedef  uint8_t    matrix_changed_t;
+#elif (MATRIX_ROWS <= 16)
+typedef  uint16_t   matrix_changed_t;
+#elif (MATRIX_ROWS <= 32)
+typedef  uint32_t   matrix_changed_t;
+#else
+#error "MATRIX_ROWS: invalid value"
+#endif
+
+#define MATRIX_CHANGED_ALL  ((matrix_changed_t)~(matrix_changed_t)0)
+
 #define MATRIX_IS_ON(row, col)  (matrix_get_row(row) && (1<<col))
 
 
@@ -50,6 +63,8 @@ void matrix_init(void);
 uint8_t matrix_scan(void);
 /* whether modified from previous scan. used after matrix_scan. */
 bool matrix_is_modified(void) __attribute__ ((deprecated));
+/* rows changed since the last call, clears the bitmap. used after matrix_scan. */
+matrix_changed_t matrix_changed_rows(void);
 /* whether a switch is on */
 bool matrix_is_on(uint8_t row, uint8_t col);
 /* matrix state on row */
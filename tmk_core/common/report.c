@@ -14,16 +14,40 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "report.h"
 #include "host.h"
 #include "keycode_config.h"
 #include "debug.h"
 #include "util.h"
 
+/* Where unaligned little endian loads are cheap, the report is scanned a word
+ * at a time. It is packed, so the words are read with memcpy, which compiles
+ * to a single load on those targets. AVR keeps the byte loops.
+ */
+#if !defined(__AVR__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#   define REPORT_WORD_SCAN
+static inline uint32_t read_word(const uint8_t* p)
+{
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+#endif
+
 uint8_t has_anykey(report_keyboard_t* keyboard_report)
 {
     uint8_t cnt = 0;
-    for (uint8_t i = 1; i < KEYBOARD_REPORT_SIZE; i++) {
+    uint8_t i = 1;
+#ifdef REPORT_WORD_SCAN
+    for (; i + 4 <= KEYBOARD_REPORT_SIZE; i += 4) {
+        uint32_t w = read_word(&keyboard_report->raw[i]);
+        // the top bit of every byte that isn't zero
+        w |= (w & 0x7F7F7F7F) + 0x7F7F7F7F;
+        cnt += __builtin_popcount(w & 0x80808080);
+    }
+#endif
+    for (; i < KEYBOARD_REPORT_SIZE; i++) {
         if (keyboard_report->raw[i])
             cnt++;
     }
@@ -35,8 +59,21 @@ uint8_t get_first_key(report_keyboard_t* keyboard_report)
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
         uint8_t i = 0;
+#ifdef REPORT_WORD_SCAN
+        for (; i + 4 <= KEYBOARD_REPORT_BITS; i += 4) {
+            uint32_t w = read_word(&keyboard_report->nkro.bits[i]);
+            if (w) {
+                // the first byte that isn't zero
+                i += __builtin_ctz(w) >> 3;
+                break;
+            }
+        }
+#endif
         for (; i < KEYBOARD_REPORT_BITS && !keyboard_report->nkro.bits[i]; i++)
             ;
+        if (i == KEYBOARD_REPORT_BITS) {
+            return 0;
+        }
         return i<<3 | biton(keyboard_report->nkro.bits[i]);
     }
 #endif
@@ -54,6 +91,60 @@ uint8_t get_first_key(report_keyboard_t* keyboard_report)
 #endif
 }
 
+#ifdef KEYBOARD_REPORT_BATCH
+static bool has_key_byte(report_keyboard_t* keyboard_report, uint8_t code)
+{
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report->keys[i] == code) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* A change is lost when a key pressed in pending, but not in sent, isn't
+ * pressed in next, or when a key released in pending is pressed again in
+ * next. Otherwise the host sees the same key presses in the same order when
+ * pending is never sent. Sent is NULL when nothing has been sent yet.
+ */
+bool can_replace_report(report_keyboard_t* sent, report_keyboard_t* pending, report_keyboard_t* next)
+{
+    static report_keyboard_t empty;
+    if (!sent) {
+        sent = &empty;
+    }
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        // the mods byte is laid out like the bits
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_SIZE; i++) {
+            uint8_t pressed = pending->raw[i] & ~sent->raw[i];
+            uint8_t released = sent->raw[i] & ~pending->raw[i];
+            if ((pressed & ~next->raw[i]) || (released & next->raw[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+    uint8_t pressed = pending->mods & ~sent->mods;
+    uint8_t released = sent->mods & ~pending->mods;
+    if ((pressed & ~next->mods) || (released & next->mods)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t code = pending->keys[i];
+        if (code && !has_key_byte(sent, code) && !has_key_byte(next, code)) {
+            return false;
+        }
+        code = sent->keys[i];
+        if (code && !has_key_byte(pending, code) && has_key_byte(next, code)) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code)
 {
 #ifdef USB_6KRO_ENABLE
@@ -201,7 +292,5 @@ void del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key)
 void clear_keys_from_report(report_keyboard_t* keyboard_report)
 {
     // not clear mods
-    for (int8_t i = 1; i < KEYBOARD_REPORT_SIZE; i++) {
-        keyboard_report->raw[i] = 0;
-    }
+    memset(&keyboard_report->raw[1], 0, KEYBOARD_REPORT_SIZE - 1);
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define REPORT_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "keycode.h"
 
 
@@ -89,6 +90,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #   define KEYBOARD_REPORT_SIZE NKRO_EPSIZE
 #   define KEYBOARD_REPORT_KEYS (NKRO_EPSIZE - 2)
 #   define KEYBOARD_REPORT_BITS (NKRO_EPSIZE - 1)
+#elif defined(PROTOCOL_TEST) && defined(NKRO_ENABLE)
+/* the test driver, same size as LUFA */
+#   define KEYBOARD_REPORT_SIZE 32
+#   define KEYBOARD_REPORT_KEYS (KEYBOARD_REPORT_SIZE - 2)
+#   define KEYBOARD_REPORT_BITS (KEYBOARD_REPORT_SIZE - 1)
 
 #else
 #   define KEYBOARD_REPORT_SIZE 8
@@ -176,6 +182,10 @@ typedef struct {
 
 uint8_t has_anykey(report_keyboard_t* keyboard_report);
 uint8_t get_first_key(report_keyboard_t* keyboard_report);
+#ifdef KEYBOARD_REPORT_BATCH
+/* whether next can be sent instead of pending without the host missing a key */
+bool can_replace_report(report_keyboard_t* sent, report_keyboard_t* pending, report_keyboard_t* next);
+#endif
 
 void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code);
 void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code);
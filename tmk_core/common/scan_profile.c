@@ -0,0 +1,162 @@
+/*
+Copyright 2017 QMK Firmware contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include "scan_profile.h"
+#include "print.h"
+
+#if defined(__AVR__)
+#   include <avr/io.h>
+#   include <util/atomic.h>
+#   include "timer.h"
+#   include "avr/timer_avr.h"
+#elif defined(PROTOCOL_CHIBIOS)
+#   include "ch.h"
+#   include "hal.h"
+#   if defined(STM32_SYSCLK)
+#       define SCAN_PROFILE_SYSCLK STM32_SYSCLK
+#   elif defined(KINETIS_SYSCLK_FREQUENCY)
+#       define SCAN_PROFILE_SYSCLK KINETIS_SYSCLK_FREQUENCY
+#   endif
+#else
+#   include <time.h>
+#endif
+
+static scan_profile_stats_t stats[SCAN_PROFILE_PROBES];
+
+static const char *const names[SCAN_PROFILE_PROBES] = {
+    [SCAN_PROFILE_KEYBOARD_TASK] = "keyboard_task",
+    [SCAN_PROFILE_MATRIX_SCAN] = "matrix_scan",
+    [SCAN_PROFILE_ACTION_EXEC] = "action_exec",
+    [SCAN_PROFILE_PROCESS_RECORD] = "process_record",
+    [SCAN_PROFILE_RGBLIGHT] = "rgblight_task",
+    [SCAN_PROFILE_MOUSEKEY] = "mousekey_task",
+    [SCAN_PROFILE_VISUALIZER] = "visualizer",
+    [SCAN_PROFILE_USB_SEND] = "usb_send",
+};
+
+void scan_profile_init(void)
+{
+#if defined(PROTOCOL_CHIBIOS) && defined(DWT_CTRL_CYCCNTENA_Msk)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    scan_profile_reset();
+}
+
+uint32_t scan_profile_clock(void)
+{
+#if defined(__AVR__)
+    /* Timer0 counts up to TIMER_RAW_TOP every millisecond */
+    uint32_t ms;
+    uint8_t raw;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms = timer_count;
+        raw = TIMER_RAW;
+#   ifndef __AVR_ATmega32A__
+        if ((TIFR0 & (1 << OCF0A)) && raw < TIMER_RAW_TOP) {
+            // the interrupt for the last millisecond is still pending
+            ms++;
+        }
+#   endif
+    }
+    return (ms * (TIMER_RAW_TOP + 1) + raw) * TIMER_PRESCALER;
+#elif defined(PROTOCOL_CHIBIOS) && defined(DWT_CTRL_CYCCNTENA_Msk)
+    return DWT->CYCCNT;
+#elif defined(PROTOCOL_CHIBIOS) && defined(SCAN_PROFILE_SYSCLK)
+    /* Cortex-M0 has no cycle counter, this only has the system tick resolution */
+    return chVTGetSystemTimeX() * (SCAN_PROFILE_SYSCLK / CH_CFG_ST_FREQUENCY);
+#elif defined(PROTOCOL_CHIBIOS)
+#   error "SCAN_PROFILE_ENABLE doesn't know the system clock of this MCU"
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)now.tv_sec * 1000000000UL + now.tv_nsec;
+#endif
+}
+
+static uint8_t bucket_of(uint32_t time)
+{
+    uint8_t bucket = 0;
+    while (bucket < SCAN_PROFILE_BUCKETS - 1 && (time >>= SCAN_PROFILE_BUCKET_BITS)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+void scan_profile_record(scan_profile_probe_t probe, uint32_t time)
+{
+    scan_profile_stats_t *s = &stats[probe];
+    if (s->count == UINT32_MAX || s->total > UINT32_MAX - time) {
+        s->count /= 2;
+        s->total /= 2;
+    }
+    if (!s->count || time < s->min) {
+        s->min = time;
+    }
+    if (time > s->max) {
+        s->max = time;
+    }
+    s->count++;
+    s->total += time;
+    uint16_t *bucket = &s->histogram[bucket_of(time)];
+    if (*bucket < UINT16_MAX) {
+        (*bucket)++;
+    }
+}
+
+const scan_profile_stats_t *scan_profile_get(scan_profile_probe_t probe)
+{
+    return &stats[probe];
+}
+
+uint32_t scan_profile_average(scan_profile_probe_t probe)
+{
+    return stats[probe].count ? stats[probe].total / stats[probe].count : 0;
+}
+
+const char *scan_profile_name(scan_profile_probe_t probe)
+{
+    return names[probe];
+}
+
+void scan_profile_reset(void)
+{
+    memset(stats, 0, sizeof(stats));
+}
+
+void scan_profile_print(void)
+{
+#if defined(__AVR__) || defined(PROTOCOL_CHIBIOS)
+    print("\n\t- Scan profile (cycles) -\n");
+#else
+    print("\n\t- Scan profile (ns) -\n");
+#endif
+    for (uint8_t probe = 0; probe < SCAN_PROFILE_PROBES; probe++) {
+        const scan_profile_stats_t *s = &stats[probe];
+        if (!s->count) {
+            continue;
+        }
+        xprintf("%s: %lu runs, min %lu avg %lu max %lu\n", names[probe],
+                (unsigned long)s->count, (unsigned long)s->min,
+                (unsigned long)scan_profile_average(probe), (unsigned long)s->max);
+        for (uint8_t bucket = 0; bucket < SCAN_PROFILE_BUCKETS; bucket++) {
+            xprintf(" %u", (unsigned)s->histogram[bucket]);
+        }
+        print("\n");
+    }
+}
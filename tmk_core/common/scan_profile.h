@@ -0,0 +1,82 @@
+/*
+Copyright 2017 QMK Firmware contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SCAN_PROFILE_H
+#define SCAN_PROFILE_H
+
+#include <stdint.h>
+
+/*
+ * Named probes around the stages of keyboard_task(), each keeping the
+ * minimum, average and maximum time taken and a histogram of the times.
+ * The times are in CPU cycles, read from DWT->CYCCNT on ARM and from the
+ * millisecond timer on AVR, and in nanoseconds on the host. With
+ * SCAN_PROFILE_ENABLE off the probes compile to nothing.
+ */
+
+typedef enum {
+    SCAN_PROFILE_KEYBOARD_TASK,
+    SCAN_PROFILE_MATRIX_SCAN,
+    SCAN_PROFILE_ACTION_EXEC,
+    SCAN_PROFILE_PROCESS_RECORD,
+    SCAN_PROFILE_RGBLIGHT,
+    SCAN_PROFILE_MOUSEKEY,
+    SCAN_PROFILE_VISUALIZER,
+    SCAN_PROFILE_USB_SEND,
+    SCAN_PROFILE_PROBES
+} scan_profile_probe_t;
+
+/* Bucket n counts the times below 8^(n+1), the last one everything else */
+#define SCAN_PROFILE_BUCKETS 8
+#define SCAN_PROFILE_BUCKET_BITS 3
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    /* halved together with the count when it would overflow */
+    uint32_t total;
+    uint16_t histogram[SCAN_PROFILE_BUCKETS];
+} scan_profile_stats_t;
+
+#ifdef SCAN_PROFILE_ENABLE
+#   define SCAN_PROFILE_BEGIN(probe) uint32_t scan_profile_start_##probe = scan_profile_clock()
+#   define SCAN_PROFILE_END(probe) \
+        scan_profile_record(SCAN_PROFILE_##probe, scan_profile_clock() - scan_profile_start_##probe)
+#else
+#   define SCAN_PROFILE_BEGIN(probe)
+#   define SCAN_PROFILE_END(probe)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void scan_profile_init(void);
+uint32_t scan_profile_clock(void);
+void scan_profile_record(scan_profile_probe_t probe, uint32_t time);
+const scan_profile_stats_t *scan_profile_get(scan_profile_probe_t probe);
+uint32_t scan_profile_average(scan_profile_probe_t probe);
+const char *scan_profile_name(scan_profile_probe_t probe);
+void scan_profile_reset(void);
+/* Prints every probe that has run to the debug console */
+void scan_profile_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -16,7 +16,7 @@
 
 #include "eeprom.h"
 
-#define EEPROM_SIZE 32
+#define EEPROM_SIZE 1024
 
 static uint8_t buffer[EEPROM_SIZE];
 
@@ -27,6 +27,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define STR(s) XSTR(s)
 #define XSTR(s) #s
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 uint8_t bitpop(uint8_t bits);
 uint8_t bitpop16(uint16_t bits);
@@ -40,4 +43,8 @@ uint8_t  bitrev(uint8_t bits);
 uint16_t bitrev16(uint16_t bits);
 uint32_t bitrev32(uint32_t bits);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -88,6 +88,26 @@ host_driver_t chibios_driver = {
 
 
 
+#ifdef KEYEVENT_SCAN_THREAD
+/* Matrix scan thread, queues the key events for keyboard_task in the main
+ * thread, so that slow actions don't delay the scanning.
+ * Only the matrix is read here, the matrix_scan_* hooks run in the main
+ * thread from keyboard_process_task.
+ */
+static THD_WORKING_AREA(waScanThread, 256);
+static THD_FUNCTION(ScanThread, arg) {
+  (void)arg;
+  chRegSetThreadName("scan");
+  while (true) {
+    // suspend_wakeup_condition() scans the matrix while suspended
+    if (USB_DRIVER.state != USB_SUSPENDED) {
+      keyboard_scan_task();
+    }
+    chThdSleepMilliseconds(1);
+  }
+}
+#endif
+
 /* Main thread
  */
 int main(void) {
@@ -144,6 +164,10 @@ int main(void) {
   keyboard_init();
   host_set_driver(driver);
 
+#ifdef KEYEVENT_SCAN_THREAD
+  chThdCreateStatic(waScanThread, sizeof(waScanThread), NORMALPRIO + 1, ScanThread, NULL);
+#endif
+
 #ifdef SLEEP_LED_ENABLE
   sleep_led_init();
 #endif
@@ -1129,6 +1129,7 @@ void send_keyboard(report_keyboard_t *report) {
   osalSysLock();
   if(usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
     osalSysUnlock();
+    host_keyboard_dropped();
     return;
   }
   osalSysUnlock();
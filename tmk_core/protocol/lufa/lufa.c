@@ -54,6 +54,7 @@
 #include "quantum.h"
 #include <util/atomic.h>
 #include "outputselect.h"
+#include "scan_profile.h"
 
 #ifdef NKRO_ENABLE
   #include "keycode_config.h"
@@ -634,7 +635,10 @@ static void send_keyboard(report_keyboard_t *report)
 
         /* Check if write ready for a polling interval around 1ms */
         while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(4);
-        if (!Endpoint_IsReadWriteAllowed()) return;
+        if (!Endpoint_IsReadWriteAllowed()) {
+            host_keyboard_dropped();
+            return;
+        }
 
         /* Write Keyboard Report Data */
         Endpoint_Write_Stream_LE(report, NKRO_EPSIZE, NULL);
@@ -647,7 +651,10 @@ static void send_keyboard(report_keyboard_t *report)
 
         /* Check if write ready for a polling interval around 10ms */
         while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
-        if (!Endpoint_IsReadWriteAllowed()) return;
+        if (!Endpoint_IsReadWriteAllowed()) {
+            host_keyboard_dropped();
+            return;
+        }
 
         /* Write Keyboard Report Data */
         Endpoint_Write_Stream_LE(report, KEYBOARD_EPSIZE, NULL);
@@ -1048,7 +1055,7 @@ void virtser_task(void)
     virtser_recv(ch);
   }
 }
-void virtser_send(const uint8_t byte)
+void virtser_send_buffer(const uint8_t *data, const uint8_t length)
 {
   uint8_t timeout = 255;
   uint8_t ep = Endpoint_GetCurrentEndpoint();
@@ -1065,7 +1072,9 @@ void virtser_send(const uint8_t byte)
 
     while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
 
-    Endpoint_Write_8(byte);
+    for (uint8_t i = 0; i < length; i++) {
+      Endpoint_Write_8(data[i]);
+    }
     CDC_Device_Flush(&cdc_device);
 
     if (Endpoint_IsINReady()) {
@@ -1075,6 +1084,11 @@ void virtser_send(const uint8_t byte)
     Endpoint_SelectEndpoint(ep);
   }
 }
+
+void virtser_send(const uint8_t byte)
+{
+  virtser_send_buffer(&byte, 1);
+}
 #endif
 
 /*******************************************************************************
@@ -1200,7 +1214,9 @@ int main(void)
 #endif
 
 #if defined(RGBLIGHT_ANIMATIONS) & defined(RGBLIGHT_ENABLE)
+        SCAN_PROFILE_BEGIN(RGBLIGHT);
         rgblight_task();
+        SCAN_PROFILE_END(RGBLIGHT);
 #endif
 
 #ifdef MODULE_ADAFRUIT_BLE
@@ -97,6 +97,7 @@ static void send_keyboard(report_keyboard_t *report)
         kbuf_head = next;
     } else {
         debug("kbuf: full\n");
+        host_keyboard_dropped();
     }
 
     // NOTE: send key strokes of Macro